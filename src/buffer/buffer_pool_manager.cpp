@@ -12,6 +12,10 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/macros.h"
@@ -21,176 +25,537 @@ namespace bustub {
 
 BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
                                      LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // TODO(students): remove this line after you have implemented the buffer pool manager
-  // throw NotImplementedException(
-  //     "BufferPoolManager is not implemented yet. If you have finished implementing BPM, please remove the throw "
-  //     "exception line in `buffer_pool_manager.cpp`.");
-
+    : pool_size_(pool_size),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      free_list_(pool_size),
+      dirty_bits_((pool_size + 63) / 64) {
   // we allocate a consecutive memory space for the buffer pool
   pages_ = new Page[pool_size_];
   replacer_ = std::make_unique<LRUKReplacer>(pool_size, replacer_k);
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
-    free_list_.emplace_back(static_cast<int>(i));
+    free_list_.Push(static_cast<frame_id_t>(i));
+  }
+
+  // Size each page table shard for its portion of the pool so steady-state inserts never rehash.
+  for (auto &shard : shards_) {
+    shard.page_table_.Reserve(pool_size_ / NUM_SHARDS + 1);
   }
+
+  writeback_thread_ = std::thread([this] { WritebackLoop(); });
+  prefetch_thread_ = std::thread([this] { PrefetchLoop(); });
 }
 
-BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
+BufferPoolManager::~BufferPoolManager() {
+  {
+    std::lock_guard<std::mutex> lock(prefetch_mutex_);
+    prefetch_shutdown_ = true;
+  }
+  prefetch_cv_.notify_one();
+  prefetch_thread_.join();
+  {
+    std::lock_guard<std::mutex> lock(flush_mutex_);
+    flush_shutdown_ = true;
+  }
+  flush_cv_.notify_one();
+  writeback_thread_.join();
+  delete[] pages_;
+}
 
-// use latch to protect buffer pool
-auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
-  // check if bufferpool is full
-  std::lock_guard<std::mutex> guard(latch_);
-  frame_id_t new_frame = 0;
-  bool is_old_page = false;
-  if (free_list_.empty()) {
-    // Evict a page from replacer
-    bool res = replacer_->Evict(&new_frame);
-    if (!res) {  // failed to release any page
-      return nullptr;
-    }
-    is_old_page = true;
-  } else {
-    // get a page from freelist
-    new_frame = free_list_.back();
-    free_list_.pop_back();
-  }
-  // insert into page_table_
-  auto new_page_id = AllocatePage();
-  *page_id = new_page_id;
-  page_table_[new_page_id] = new_frame;
-  replacer_->SetEvictable(new_frame, false);
-  replacer_->RecordAccess(new_frame);
-  auto page = pages_ + new_frame;
-  if (is_old_page) {
-    // do some cleanup
-    if (page->page_id_ != INVALID_PAGE_ID && page->page_id_ != new_page_id) {
-      page_table_.erase(page->page_id_);
+auto BufferPoolManager::AcquireFrame(frame_id_t *frame_id) -> bool {
+  // Every frame this function pops off the free list or wins from the replacer is invisible to
+  // other threads until the caller publishes it in the page table or hands it back through
+  // ReleaseFrame. frames_in_transit_ counts those frames, and the count is always raised
+  // *before* the frame goes dark: on success the caller inherits the token, and publishing (in
+  // NewPage/FetchPage) or ReleaseFrame releases it. The exhaustion test at the bottom depends on
+  // that ordering -- a zero count means no unpinned frame is hidden at the instant of the load.
+  bool verify_pass = false;
+  while (true) {
+    frames_in_transit_.fetch_add(1, std::memory_order_acq_rel);
+    if (free_list_.Pop(frame_id)) {
+      return true;
+    }
+    frames_in_transit_.fetch_sub(1, std::memory_order_acq_rel);
+    // Evict until we manage to claim a victim. A concurrent FetchPage may re-pin the victim
+    // between Evict() and taking its shard latch, in which case we pick another victim.
+    frame_id_t victim;
+    while (true) {
+      frames_in_transit_.fetch_add(1, std::memory_order_acq_rel);
+      if (!replacer_->Evict(&victim)) {
+        frames_in_transit_.fetch_sub(1, std::memory_order_acq_rel);
+        break;
+      }
+      auto page = pages_ + victim;
+      // The Page header doubles as the frame -> page_id inverse table: every frame handed out by
+      // this function carries the id of the page it holds, so the victim's old mapping is found
+      // directly instead of conditionally cleaning up inside NewPage/FetchPage.
+      auto old_page_id = page->page_id_;
+      auto &shard = ShardFor(old_page_id);
+      bool claimed = false;
+      bool write_back = false;
+      {
+        std::lock_guard<std::mutex> guard(shard.latch_);
+        auto *slot = shard.page_table_.Find(old_page_id);
+        if (slot != nullptr && *slot == victim && page->pin_count_ == 0) {
+          if (page->IsDirty()) {
+            // A dirty victim stays mapped and pinned while its data goes to disk: if the mapping
+            // were erased first, a concurrent fetch of this page would miss and race the
+            // write-back for the stale on-disk bytes. The dirty flag is cleared up front so a
+            // writer that re-dirties the page mid-write is detected at the re-check below.
+            page->pin_count_.store(1, std::memory_order_relaxed);
+            page->is_dirty_ = false;
+            ClearDirtyBit(victim);
+            write_back = true;
+          } else {
+            shard.page_table_.Erase(old_page_id);
+            // Drop any access history a concurrent pin/unpin may have re-recorded for this frame.
+            replacer_->Remove(victim);
+            claimed = true;
+          }
+        } else if (slot != nullptr && *slot == victim) {
+          // The victim was re-pinned between Evict() and this latch. Evict() already dropped its
+          // replacer node, and SetEvictable on an untracked frame is a no-op, so re-register the
+          // frame here -- otherwise nothing ever puts it back and the pool leaks it for good.
+          replacer_->RecordAccess(victim);
+          replacer_->SetEvictable(victim, page->pin_count_ == 0);
+        }
+      }
+      if (write_back) {
+        // Only the shard latch is dropped for the I/O; the held pin keeps the frame ours to probe.
+        disk_manager_->WritePage(old_page_id, page->GetData());
+        {
+          std::lock_guard<std::mutex> guard(shard.latch_);
+          if (page->pin_count_ == 1 && !page->IsDirty()) {
+            shard.page_table_.Erase(old_page_id);
+            replacer_->Remove(victim);
+            claimed = true;
+          } else {
+            // The page was re-dirtied or re-pinned during the write-back; it stays resident, so
+            // it must go back under the replacer's control. Re-register unconditionally: Evict()
+            // dropped its node, and a fetcher's eventual unpin only calls SetEvictable, which
+            // cannot resurrect an untracked frame -- skipping this here leaks the frame for good.
+            replacer_->RecordAccess(victim);
+            if (page->pin_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+              replacer_->SetEvictable(victim, true);
+            }
+          }
+        }
+      }
+      if (!claimed) {
+        frames_in_transit_.fetch_sub(1, std::memory_order_acq_rel);
+        continue;
+      }
+      page->page_id_ = INVALID_PAGE_ID;
+      page->pin_count_ = 0;
+      *frame_id = victim;
+      return true;
     }
-    if (page->IsDirty()) {
-      disk_manager_->WritePage(page->page_id_, page->GetData());
-      page->is_dirty_ = false;
+    // No evictable frame right now. Frames in transit resurface shortly -- as a free frame or as
+    // an evictable page again -- so wait for them instead of failing a fetch the pool can
+    // satisfy; with nothing in transit the pool really is fully pinned.
+    if (frames_in_transit_.load(std::memory_order_acquire) == 0) {
+      if (verify_pass) {
+        return false;
+      }
+      // Anything that was hidden while the probes above ran has surfaced by the time this load
+      // saw zero, so one more pass separates frames that surfaced mid-pass from real exhaustion.
+      verify_pass = true;
+      continue;
     }
+    verify_pass = false;
+    std::this_thread::yield();
   }
+}
+
+void BufferPoolManager::ReleaseFrame(frame_id_t frame_id) {
+  free_list_.Push(frame_id);
+  // The frame is visible in the free list again; release its transit token (see AcquireFrame).
+  frames_in_transit_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
+  frame_id_t frame_id;
+  if (!AcquireFrame(&frame_id)) {
+    return nullptr;
+  }
+  auto new_page_id = AllocatePage();
+  *page_id = new_page_id;
+  auto page = pages_ + frame_id;
+  auto &shard = ShardFor(new_page_id);
+  std::lock_guard<std::mutex> guard(shard.latch_);
+  shard.page_table_.Insert(new_page_id, frame_id);
+  replacer_->RecordAccess(frame_id);
+  replacer_->SetEvictable(frame_id, false);
   page->page_id_ = new_page_id;
   page->pin_count_ = 1;
   page->ResetMemory();
+  // Published and pinned: the frame is visible again, so release its transit token.
+  frames_in_transit_.fetch_sub(1, std::memory_order_acq_rel);
   return page;
 }
 
 auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
-  std::lock_guard<std::mutex> guard(latch_);
   if (page_id >= next_page_id_) {
     LOG_DEBUG("Fetch Non Existed Page page_id %d, next_page_id %d", (int)page_id, (int)next_page_id_);
     return nullptr;
   }
-  frame_id_t frame_id;
-  bool is_old_page = false;
-  bool is_first_fetch = true;
-  if (page_table_.find(page_id) != page_table_.end()) {
-    frame_id = page_table_[page_id];
-    is_first_fetch = false;
-  } else {
-    if (free_list_.empty()) {
-      bool res = replacer_->Evict(&frame_id);
-      if (!res) {
-        return nullptr;
+  auto &shard = ShardFor(page_id);
+  {
+    std::lock_guard<std::mutex> guard(shard.latch_);
+    shard.page_table_.Prefetch(page_id);
+    auto *slot = shard.page_table_.Find(page_id);
+    if (slot != nullptr) {
+      auto frame_id = *slot;
+      // Prefetch the Page header so the miss overlaps with the replacer bookkeeping below.
+      __builtin_prefetch(pages_ + frame_id, 1, 1);
+      shard.pending_access_[shard.pending_n_++] = frame_id;
+      if (shard.pending_n_ == ACCESS_BATCH_SIZE) {
+        replacer_->RecordAccessBatch(shard.pending_access_.data(), shard.pending_n_);
+        shard.pending_n_ = 0;
+      }
+      auto page = pages_ + frame_id;
+      if (page->pin_count_.fetch_add(1, std::memory_order_acq_rel) == 0) {
+        replacer_->SetEvictable(frame_id, false);
       }
-      is_old_page = true;
-    } else {
-      frame_id = free_list_.back();
-      free_list_.pop_back();
+      return page;
     }
-    page_table_[page_id] = frame_id;
+  }
+  // Miss: claim a frame without holding the shard latch, then publish the mapping.
+  frame_id_t frame_id;
+  if (!AcquireFrame(&frame_id)) {
+    return nullptr;
   }
   auto page = pages_ + frame_id;
-  if (is_old_page) {
-    // do some cleanup
-    if (page->page_id_ != INVALID_PAGE_ID && page->page_id_ != page_id) {
-      page_table_.erase(page->page_id_);
-    }
-    if (page->IsDirty()) {
-      disk_manager_->WritePage(page->page_id_, page->GetData());
-      page->is_dirty_ = false;
+  // Write-latch the still-private frame before publishing it, then drop the shard latch for the
+  // disk read: concurrent fetches of the same page see the mapping immediately and block on the
+  // page latch only until the read completes, instead of every fetch in the shard stalling behind
+  // the I/O. Page latches are always acquired before shard latches (the page guards unpin while
+  // still latched), so this cannot deadlock.
+  page->WLatch();
+  {
+    std::lock_guard<std::mutex> guard(shard.latch_);
+    auto *slot = shard.page_table_.Find(page_id);
+    if (slot != nullptr) {
+      // Someone else brought the page in while we were claiming a frame; hand our frame back.
+      page->WUnlatch();
+      ReleaseFrame(frame_id);
+      auto other_frame_id = *slot;
+      auto other = pages_ + other_frame_id;
+      if (other->pin_count_.fetch_add(1, std::memory_order_acq_rel) == 0) {
+        replacer_->SetEvictable(other_frame_id, false);
+      }
+      replacer_->RecordAccess(other_frame_id);
+      return other;
     }
-    page->pin_count_ = 0;
-  }
-  page->page_id_ = page_id;
-  if (is_first_fetch) {
-    disk_manager_->ReadPage(page->page_id_, page->GetData());
+    shard.page_table_.Insert(page_id, frame_id);
+    page->page_id_ = page_id;
+    page->pin_count_ = 1;
+    replacer_->RecordAccess(frame_id);
+    replacer_->SetEvictable(frame_id, false);
+    // Published and pinned: the frame is visible again, so release its transit token.
+    frames_in_transit_.fetch_sub(1, std::memory_order_acq_rel);
   }
-  page->pin_count_++;
-  replacer_->SetEvictable(frame_id, false);
-  replacer_->RecordAccess(frame_id);
-  return pages_ + frame_id;
+  disk_manager_->ReadPage(page_id, page->GetData());
+  page->WUnlatch();
+  return page;
 }
 
 auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
-  std::lock_guard<std::mutex> guard(latch_);
-  if (page_table_.find(page_id) == page_table_.end()) {
-    LOG_DEBUG("Page_id Not Fould %d", (int)page_id);
-    return false;
+  auto &shard = ShardFor(page_id);
+  frame_id_t frame_id;
+  Page *page;
+  {
+    std::lock_guard<std::mutex> guard(shard.latch_);
+    shard.page_table_.Prefetch(page_id);
+    auto *slot = shard.page_table_.Find(page_id);
+    if (slot == nullptr) {
+      LOG_DEBUG("Page_id Not Fould %d", (int)page_id);
+      return false;
+    }
+    frame_id = *slot;
+    page = pages_ + frame_id;
   }
-  frame_id_t frame_id = page_table_[page_id];
-  auto page = pages_ + frame_id;
-  if (page->pin_count_ == 0) {
-    LOG_DEBUG("Unpin pin_count is Zero page_id %d", (int)page_id);
-    return false;
+  // The caller holds a pin, so the frame cannot be evicted underneath us; decrement lock-free.
+  if (is_dirty) {
+    page->is_dirty_.store(true, std::memory_order_relaxed);
+    MarkDirtyBit(frame_id);
+  }
+  auto pin_count = page->pin_count_.load(std::memory_order_acquire);
+  bool in_transit = false;
+  do {
+    if (pin_count == 0) {
+      LOG_DEBUG("Unpin pin_count is Zero page_id %d", (int)page_id);
+      if (in_transit) {
+        frames_in_transit_.fetch_sub(1, std::memory_order_acq_rel);
+      }
+      return false;
+    }
+    if (pin_count == 1 && !in_transit) {
+      // About to drop the last pin: between the decrement and the latched handoff below the frame
+      // is unpinned yet untracked by the replacer. Count the window before the decrement can land
+      // so AcquireFrame's exhaustion test never sees the frame hidden with nothing in transit.
+      frames_in_transit_.fetch_add(1, std::memory_order_acq_rel);
+      in_transit = true;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1, std::memory_order_acq_rel));
+  if (pin_count == 1) {
+    // The count hit zero. Re-validate under the shard latch so this cannot race with a concurrent
+    // fetch re-pinning the page: whichever update runs last sees the then-current pin count.
+    std::lock_guard<std::mutex> guard(shard.latch_);
+    auto *slot = shard.page_table_.Find(page_id);
+    if (slot != nullptr && *slot == frame_id && page->pin_count_.load(std::memory_order_acquire) == 0) {
+      replacer_->SetEvictable(frame_id, true);
+    }
   }
-  page->pin_count_--;
-  if (page->pin_count_ == 0) {
-    replacer_->SetEvictable(frame_id, true);
+  if (in_transit) {
+    frames_in_transit_.fetch_sub(1, std::memory_order_acq_rel);
   }
-  if (is_dirty && !page->is_dirty_) {
-    page->is_dirty_ = true;
+  return true;
+}
+
+auto BufferPoolManager::UnpinFrame(Page *page, bool is_dirty) -> bool {
+  const auto frame_id = static_cast<frame_id_t>(page - pages_);
+  // Capture the id before letting the pin count reach zero: once it does, a concurrent eviction
+  // may remap the frame and GetPageId() would name somebody else's page.
+  const auto page_id = page->GetPageId();
+  if (is_dirty) {
+    page->is_dirty_.store(true, std::memory_order_relaxed);
+    MarkDirtyBit(frame_id);
+  }
+  auto pin_count = page->pin_count_.load(std::memory_order_acquire);
+  bool in_transit = false;
+  do {
+    if (pin_count == 0) {
+      LOG_DEBUG("UnpinFrame pin_count is Zero page_id %d", (int)page_id);
+      if (in_transit) {
+        frames_in_transit_.fetch_sub(1, std::memory_order_acq_rel);
+      }
+      return false;
+    }
+    if (pin_count == 1 && !in_transit) {
+      // Same hidden window as UnpinPage: count the last-pin drop before it lands.
+      frames_in_transit_.fetch_add(1, std::memory_order_acq_rel);
+      in_transit = true;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1, std::memory_order_acq_rel));
+  if (pin_count == 1) {
+    // Same last-pin handoff as UnpinPage: re-validate the mapping under the shard latch so a
+    // concurrent fetch re-pinning (or remapping) the frame wins.
+    auto &shard = ShardFor(page_id);
+    std::lock_guard<std::mutex> guard(shard.latch_);
+    auto *slot = shard.page_table_.Find(page_id);
+    if (slot != nullptr && *slot == frame_id && page->pin_count_.load(std::memory_order_acquire) == 0) {
+      replacer_->SetEvictable(frame_id, true);
+    }
+  }
+  if (in_transit) {
+    frames_in_transit_.fetch_sub(1, std::memory_order_acq_rel);
   }
   return true;
 }
 
 auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
-  std::lock_guard<std::mutex> guard(latch_);
-  if (page_id == INVALID_PAGE_ID || page_table_.find(page_id) == page_table_.end()) {
+  if (page_id == INVALID_PAGE_ID) {
     return false;
   }
-  auto frame_id = page_table_[page_id];
-  auto page = pages_ + frame_id;
-  disk_manager_->WritePage(page->page_id_, page->GetData());
-  page->is_dirty_ = false;
+  frame_id_t frame_id;
+  {
+    auto &shard = ShardFor(page_id);
+    std::lock_guard<std::mutex> guard(shard.latch_);
+    auto *slot = shard.page_table_.Find(page_id);
+    if (slot == nullptr) {
+      return false;
+    }
+    frame_id = *slot;
+  }
+  // Group commit: enqueue the request and wait for the batch containing it to hit disk. If the
+  // page gets evicted in the meantime, the eviction path writes it back, so durability holds
+  // either way.
+  std::unique_lock<std::mutex> lock(flush_mutex_);
+  flush_queue_.emplace_back(page_id, frame_id);
+  auto my_gen = flush_gen_;
+  flush_cv_.notify_one();
+  flush_done_cv_.wait(lock, [&] { return flush_completed_ >= my_gen; });
   return true;
 }
 
+void BufferPoolManager::WritebackLoop() {
+  std::unique_lock<std::mutex> lock(flush_mutex_);
+  while (true) {
+    flush_cv_.wait(lock, [&] { return flush_shutdown_ || !flush_queue_.empty(); });
+    if (flush_queue_.empty()) {
+      if (flush_shutdown_) {
+        return;
+      }
+      continue;
+    }
+    auto batch = std::move(flush_queue_);
+    flush_queue_.clear();
+    auto gen = flush_gen_++;
+    lock.unlock();
+    WriteFlushBatch(&batch);
+    lock.lock();
+    flush_completed_ = gen;
+    flush_done_cv_.notify_all();
+  }
+}
+
+void BufferPoolManager::WriteFlushBatch(std::vector<std::pair<page_id_t, frame_id_t>> *batch) {
+  // Quiesce the table for the duration of the batch so every entry can be re-validated and the
+  // runs written consistently; see FlushAllPages for the latch-ordering argument.
+  std::array<std::unique_lock<std::mutex>, NUM_SHARDS> guards;
+  for (size_t i = 0; i < NUM_SHARDS; ++i) {
+    guards[i] = std::unique_lock<std::mutex>(shards_[i].latch_);
+  }
+  std::sort(batch->begin(), batch->end());
+  std::vector<std::pair<page_id_t, Page *>> valid;
+  valid.reserve(batch->size());
+  for (const auto &[page_id, frame_id] : *batch) {
+    if (!valid.empty() && valid.back().first == page_id) {
+      continue;  // coalesce duplicate requests for the same page
+    }
+    auto *slot = ShardFor(page_id).page_table_.Find(page_id);
+    if (slot == nullptr || *slot != frame_id) {
+      continue;  // evicted since enqueue; the eviction already wrote it back
+    }
+    valid.emplace_back(page_id, pages_ + frame_id);
+  }
+  std::vector<const char *> bufs;
+  for (size_t i = 0; i < valid.size();) {
+    auto start = valid[i].first;
+    bufs.clear();
+    auto j = i;
+    while (j < valid.size() && valid[j].first == start + static_cast<page_id_t>(j - i) &&
+           bufs.size() < WRITE_COMBINE_LIMIT) {
+      bufs.push_back(valid[j].second->GetData());
+      valid[j].second->is_dirty_ = false;
+      ClearDirtyBit(static_cast<frame_id_t>(valid[j].second - pages_));
+      ++j;
+    }
+    disk_manager_->WritePages(start, bufs);
+    i = j;
+  }
+}
+
+void BufferPoolManager::PrefetchPage(page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID || page_id >= next_page_id_) {
+    return;
+  }
+  {
+    auto &shard = ShardFor(page_id);
+    std::lock_guard<std::mutex> guard(shard.latch_);
+    if (shard.page_table_.Find(page_id) != nullptr) {
+      return;  // already resident
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(prefetch_mutex_);
+    if (prefetch_queue_.size() >= PREFETCH_QUEUE_LIMIT) {
+      return;  // just a hint; drop it rather than stall the caller
+    }
+    prefetch_queue_.push_back(page_id);
+  }
+  prefetch_cv_.notify_one();
+}
+
+auto BufferPoolManager::PeekFrameData(page_id_t page_id) -> const char * {
+  auto &shard = ShardFor(page_id);
+  std::lock_guard<std::mutex> guard(shard.latch_);
+  auto *slot = shard.page_table_.Find(page_id);
+  return slot != nullptr ? pages_[*slot].GetData() : nullptr;
+}
+
+void BufferPoolManager::PrefetchLoop() {
+  std::unique_lock<std::mutex> lock(prefetch_mutex_);
+  while (true) {
+    prefetch_cv_.wait(lock, [&] { return prefetch_shutdown_ || !prefetch_queue_.empty(); });
+    if (prefetch_shutdown_) {
+      return;  // pending hints are droppable by definition
+    }
+    auto batch = std::move(prefetch_queue_);
+    prefetch_queue_.clear();
+    lock.unlock();
+    // Fetch-then-unpin leaves the page resident and evictable while reusing the fetch path's
+    // handling of races with concurrent fetches and evictions.
+    for (auto page_id : batch) {
+      if (FetchPage(page_id) != nullptr) {
+        UnpinPage(page_id, false);
+      }
+    }
+    lock.lock();
+  }
+}
+
 void BufferPoolManager::FlushAllPages() {
-  std::lock_guard<std::mutex> guard(latch_);
-  for (size_t i = 0; i < pool_size_; ++i) {
-    auto page = pages_ + i;
-    disk_manager_->WritePage(page->page_id_, page->GetData());
-    page->is_dirty_ = false;
+  // Quiesce the pool: take every shard latch (in index order, so this cannot deadlock with the
+  // single-shard paths) so the set of resident pages is stable while the writes are batched.
+  std::array<std::unique_lock<std::mutex>, NUM_SHARDS> guards;
+  for (size_t i = 0; i < NUM_SHARDS; ++i) {
+    guards[i] = std::unique_lock<std::mutex>(shards_[i].latch_);
+  }
+  // Scan the dirty bitmap, skipping 64 clean frames per word; count-trailing-zeros walks the set
+  // bits of each nonzero word.
+  std::vector<std::pair<page_id_t, Page *>> dirty;
+  for (size_t w = 0; w < dirty_bits_.size(); ++w) {
+    auto word = dirty_bits_[w].exchange(0, std::memory_order_relaxed);
+    while (word != 0) {
+      auto frame_id = static_cast<frame_id_t>((w << 6) + __builtin_ctzll(word));
+      word &= word - 1;
+      auto page = pages_ + frame_id;
+      if (page->page_id_ != INVALID_PAGE_ID && page->IsDirty()) {
+        dirty.emplace_back(page->page_id_, page);
+      }
+    }
+  }
+  // Sort by page id and combine runs of consecutive ids into single WritePages calls.
+  std::sort(dirty.begin(), dirty.end());
+  std::vector<const char *> bufs;
+  for (size_t i = 0; i < dirty.size();) {
+    auto start = dirty[i].first;
+    bufs.clear();
+    auto j = i;
+    while (j < dirty.size() && dirty[j].first == start + static_cast<page_id_t>(j - i) &&
+           bufs.size() < WRITE_COMBINE_LIMIT) {
+      bufs.push_back(dirty[j].second->GetData());
+      dirty[j].second->is_dirty_ = false;
+      ++j;
+    }
+    disk_manager_->WritePages(start, bufs);
+    i = j;
   }
 }
 
 auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
-  std::lock_guard<std::mutex> guard(latch_);
-  if (page_id == INVALID_PAGE_ID || page_table_.find(page_id) == page_table_.end()) {
+  if (page_id == INVALID_PAGE_ID) {
+    return true;
+  }
+  auto &shard = ShardFor(page_id);
+  std::lock_guard<std::mutex> guard(shard.latch_);
+  auto *slot = shard.page_table_.Find(page_id);
+  if (slot == nullptr) {
     return true;
   }
-  auto frame_id = page_table_[page_id];
+  auto frame_id = *slot;
   auto page = pages_ + frame_id;
-  bool is_count_zero = page->pin_count_ == 0;
-  if (!is_count_zero) {
+  if (page->pin_count_ > 0) {
     return false;
   }
-  page_table_.erase(page_id);
+  // The frame goes dark here -- off the page table and the replacer but not yet on the free
+  // list -- so raise the transit count first; ReleaseFrame below releases the token.
+  frames_in_transit_.fetch_add(1, std::memory_order_acq_rel);
+  shard.page_table_.Erase(page_id);
   replacer_->Remove(frame_id);
-  free_list_.push_back(frame_id);
   if (page->is_dirty_) {
     disk_manager_->WritePage(page->page_id_, page->GetData());
     page->is_dirty_ = false;
+    ClearDirtyBit(frame_id);
   }
   page->page_id_ = INVALID_PAGE_ID;
   page->ResetMemory();
   page->pin_count_ = 0;
+  ReleaseFrame(frame_id);
   DeallocatePage(page_id);
   return true;
 }
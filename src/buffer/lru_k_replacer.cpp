@@ -15,67 +15,136 @@
 
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {
+  BUSTUB_ASSERT(k <= LRUKNode::MAX_K, "lookback window exceeds the node history capacity");
+}
 
-auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
-  std::lock_guard<std::mutex> guard(latch_);
-  frame_id_t delete_frame_id = 0;
-  bool is_found = false;
-  size_t distance = 0;
-  size_t last_visit_time = 0;
-  for (const auto &iter : node_store_) {
-    auto &node = iter.second;
-    if (node.is_evictable_) {
-      size_t tmp_distance = 0;
-      size_t tmp_last_visit_time = node.history_.back();
-      if (node.history_.size() == k_) {
-        tmp_distance = current_timestamp_ - node.history_.back();
-      } else {
-        tmp_distance = static_cast<size_t>(-1);
-      }
-      if (tmp_distance > distance || (tmp_distance == distance && tmp_last_visit_time < last_visit_time)) {
-        distance = tmp_distance;
-        last_visit_time = tmp_last_visit_time;
-        delete_frame_id = iter.first;
-        is_found = true;
+auto LRUKReplacer::KeyOf(const LRUKNode &node) -> EvictionKey {
+  // For a full history the back entry is the kth most recent access; the frame with the smallest
+  // such timestamp has the largest backward k-distance. For a short history the back entry is the
+  // earliest access, which is exactly the classical-LRU tie-breaker among +inf-distance frames.
+  return (static_cast<EvictionKey>(node.Back()) << 32) | static_cast<uint32_t>(node.fid_);
+}
+
+void LRUKReplacer::InsertKey(const LRUKNode &node) {
+  if (node.HistorySize() < k_) {
+    inf_set_.insert(KeyOf(node));
+  } else {
+    finite_set_.insert(KeyOf(node));
+  }
+}
+
+void LRUKReplacer::EraseKey(const LRUKNode &node) {
+  if (node.HistorySize() < k_) {
+    inf_set_.erase(KeyOf(node));
+  } else {
+    finite_set_.erase(KeyOf(node));
+  }
+}
+
+auto LRUKReplacer::SweepVictim(const std::set<EvictionKey> &candidates) -> std::optional<frame_id_t> {
+  // Clock-style second chance on top of the LRU-k order: walk the candidates in eviction
+  // preference and spend one usage credit per pass instead of evicting. Credits saturate at
+  // MAX_USAGE and only decrease here, so at most MAX_USAGE + 1 sweeps reach a zero-credit frame.
+  while (!candidates.empty()) {
+    for (auto key : candidates) {
+      auto &node = node_store_.find(static_cast<frame_id_t>(static_cast<uint32_t>(key)))->second;
+      if (node.usage_count_ > 0) {
+        node.usage_count_--;
+        continue;
       }
+      return node.fid_;
     }
   }
-  if (!is_found) {
+  return std::nullopt;
+}
+
+auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto victim = SweepVictim(inf_set_);
+  if (!victim.has_value()) {
+    victim = SweepVictim(finite_set_);
+  }
+  if (!victim.has_value()) {
     return false;
   }
-  *frame_id = delete_frame_id;
-  node_store_.erase(delete_frame_id);
+  frame_id_t delete_frame_id = *victim;
+  auto iter = node_store_.find(delete_frame_id);
+  EraseKey(iter->second);
+  node_store_.erase(iter);
   curr_size_--;
+  *frame_id = delete_frame_id;
   return true;
 }
 
 void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type) {
   std::lock_guard<std::mutex> guard(latch_);
-  if (node_store_.find(frame_id) != node_store_.end() && node_store_[frame_id].fid_ == frame_id) {
-    auto &node = node_store_[frame_id];
-    node.history_.push_front(current_timestamp_++);
-    if (node.history_.size() > k_) {
-      node.history_.pop_back();
+  auto iter = node_store_.find(frame_id);
+  if (iter != node_store_.end()) {
+    auto &node = iter->second;
+    if (k_ == 1) {
+      // Plain-LRU degeneration: the eviction key is just the last access, so overwrite the single
+      // retained timestamp in place instead of running the ring and history-length bookkeeping.
+      if (node.is_evictable_) {
+        finite_set_.erase(KeyOf(node));
+        node.Touch(current_timestamp_++);
+        finite_set_.insert(KeyOf(node));
+      } else {
+        node.Touch(current_timestamp_++);
+      }
+      return;
+    }
+    if (node.is_evictable_) {
+      EraseKey(node);
+    }
+    node.PushFront(current_timestamp_++, k_);
+    if (node.is_evictable_) {
+      InsertKey(node);
     }
   } else {
     LRUKNode node(frame_id);
-    node.history_.push_front(current_timestamp_++);
-    node_store_[frame_id] = std::move(node);
+    node.PushFront(current_timestamp_++, k_);
+    node_store_[frame_id] = node;
+  }
+}
+
+void LRUKReplacer::RecordAccessBatch(const frame_id_t *frames, size_t n) {
+  std::lock_guard<std::mutex> guard(latch_);
+  for (size_t i = 0; i < n; ++i) {
+    auto iter = node_store_.find(frames[i]);
+    if (iter == node_store_.end()) {
+      continue;
+    }
+    auto &node = iter->second;
+    if (node.is_evictable_) {
+      EraseKey(node);
+    }
+    node.PushFront(current_timestamp_++, k_);
+    // Batched events come from buffer pool fetch hits, the high-frequency path; charge usage
+    // credit so frames hot enough to fill a batch survive a burst of evictions (second chance).
+    if (node.usage_count_ < LRUKNode::MAX_USAGE) {
+      node.usage_count_++;
+    }
+    if (node.is_evictable_) {
+      InsertKey(node);
+    }
   }
 }
 
 void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
   std::lock_guard<std::mutex> guard(latch_);
-  if (node_store_.find(frame_id) != node_store_.end() && node_store_[frame_id].fid_ == frame_id) {
-    auto &node = node_store_[frame_id];
+  auto iter = node_store_.find(frame_id);
+  if (iter != node_store_.end()) {
+    auto &node = iter->second;
     if (set_evictable == node.is_evictable_) {
       return;
     }
     node.is_evictable_ = set_evictable;
     if (set_evictable) {
+      InsertKey(node);
       curr_size_++;
     } else {
+      EraseKey(node);
       curr_size_--;
     }
   }
@@ -83,15 +152,17 @@ void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
 
 void LRUKReplacer::Remove(frame_id_t frame_id) {
   std::lock_guard<std::mutex> guard(latch_);
-  if (node_store_.find(frame_id) == node_store_.end()) {
+  auto iter = node_store_.find(frame_id);
+  if (iter == node_store_.end()) {
     return;
   }
-  auto &node = node_store_[frame_id];
+  auto &node = iter->second;
   if (!node.is_evictable_) {
     // throw
     return;
   }
-  node_store_.erase(frame_id);
+  EraseKey(node);
+  node_store_.erase(iter);
   curr_size_--;
 }
 
@@ -9,6 +9,7 @@
 // Copyright (c) 2015-2019, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+#include <algorithm>
 #include <set>
 #include <stack>
 
@@ -19,252 +20,482 @@
 
 namespace bustub {
 
+namespace {
+
+using LockMode = LockManager::LockMode;
+
+/** @return the bit representing a lock mode, for building mode masks */
+constexpr auto ModeBit(LockMode mode) -> uint8_t { return static_cast<uint8_t>(1U << static_cast<uint8_t>(mode)); }
+
+// The LockMode predicates below used to be 5-way switch cascades executed on every lock
+// operation. Each is now a constant mask table indexed by the held/current mode, with one bit per
+// other mode, so a check is a load, a shift, and a mask instead of a branch tree. Entries are in
+// enum order: SHARED, EXCLUSIVE, INTENTION_SHARED, INTENTION_EXCLUSIVE, SHARED_INTENTION_EXCLUSIVE.
+
+/** kCompatible[held] has the bit of every mode that may be granted alongside `held`. */
+constexpr std::array<uint8_t, 5> kCompatible = {
+    /* S   */ ModeBit(LockMode::SHARED) | ModeBit(LockMode::INTENTION_SHARED),
+    /* X   */ 0,
+    /* IS  */ ModeBit(LockMode::INTENTION_SHARED) | ModeBit(LockMode::INTENTION_EXCLUSIVE) |
+        ModeBit(LockMode::SHARED) | ModeBit(LockMode::SHARED_INTENTION_EXCLUSIVE),
+    /* IX  */ ModeBit(LockMode::INTENTION_SHARED) | ModeBit(LockMode::INTENTION_EXCLUSIVE),
+    /* SIX */ ModeBit(LockMode::INTENTION_SHARED),
+};
+
+/** kUpgrade[held] has the bit of every mode `held` may be upgraded to. */
+constexpr std::array<uint8_t, 5> kUpgrade = {
+    /* S   */ ModeBit(LockMode::EXCLUSIVE) | ModeBit(LockMode::SHARED_INTENTION_EXCLUSIVE),
+    /* X   */ 0,
+    /* IS  */ ModeBit(LockMode::SHARED) | ModeBit(LockMode::EXCLUSIVE) | ModeBit(LockMode::INTENTION_EXCLUSIVE) |
+        ModeBit(LockMode::SHARED_INTENTION_EXCLUSIVE),
+    /* IX  */ ModeBit(LockMode::EXCLUSIVE) | ModeBit(LockMode::SHARED_INTENTION_EXCLUSIVE),
+    /* SIX */ ModeBit(LockMode::EXCLUSIVE),
+};
+
+/** kSatisfied[held] has the bit of every requested mode already subsumed by `held`. */
+constexpr std::array<uint8_t, 5> kSatisfied = {
+    /* S   */ ModeBit(LockMode::INTENTION_SHARED) | ModeBit(LockMode::SHARED),
+    /* X   */ ModeBit(LockMode::INTENTION_SHARED) | ModeBit(LockMode::SHARED) |
+        ModeBit(LockMode::SHARED_INTENTION_EXCLUSIVE) | ModeBit(LockMode::EXCLUSIVE),
+    /* IS  */ ModeBit(LockMode::INTENTION_SHARED),
+    /* IX  */ ModeBit(LockMode::INTENTION_SHARED) | ModeBit(LockMode::INTENTION_EXCLUSIVE),
+    /* SIX */ ModeBit(LockMode::INTENTION_SHARED) | ModeBit(LockMode::SHARED) |
+        ModeBit(LockMode::SHARED_INTENTION_EXCLUSIVE),
+};
+
+/** Every lock mode's bit set: no isolation-level restriction applies. */
+constexpr uint8_t kAllModes = ModeBit(LockMode::SHARED) | ModeBit(LockMode::EXCLUSIVE) |
+                              ModeBit(LockMode::INTENTION_SHARED) | ModeBit(LockMode::INTENTION_EXCLUSIVE) |
+                              ModeBit(LockMode::SHARED_INTENTION_EXCLUSIVE);
+
+/**
+ * kAllowedModes[iso_level][state] has the bit of every mode a transaction at that isolation level
+ * may request in that state, folding the four cascaded isolation checks of CanTxnTakeLock into one
+ * table load. Indexed by the IsolationLevel and TransactionState enum orders
+ * (READ_UNCOMMITTED, REPEATABLE_READ, READ_COMMITTED) x (GROWING, SHRINKING, COMMITTED, ABORTED).
+ */
+constexpr std::array<std::array<uint8_t, 4>, 3> kAllowedModes = {{
+    // READ_UNCOMMITTED: never any shared-flavored lock; X/IX only while growing.
+    {{ModeBit(LockMode::EXCLUSIVE) | ModeBit(LockMode::INTENTION_EXCLUSIVE), 0, 0, 0}},
+    // REPEATABLE_READ: nothing while shrinking.
+    {{kAllModes, 0, kAllModes, 0}},
+    // READ_COMMITTED: only IS/S while shrinking.
+    {{kAllModes, ModeBit(LockMode::INTENTION_SHARED) | ModeBit(LockMode::SHARED), kAllModes, 0}},
+}};
+
+/** Table lock modes that cover an exclusive row lock. */
+constexpr uint8_t kRowExclusiveTableModes =
+    ModeBit(LockMode::INTENTION_EXCLUSIVE) | ModeBit(LockMode::EXCLUSIVE) |
+    ModeBit(LockMode::SHARED_INTENTION_EXCLUSIVE);
+
+/** @return true if `mode`'s bit is set in `mask` */
+constexpr auto MaskHas(uint8_t mask, LockMode mode) -> bool {
+  return ((mask >> static_cast<uint8_t>(mode)) & 1U) != 0;
+}
+
+/** The transaction's table lock set holding locks of each mode, indexed like the mask tables. */
+const std::array<std::shared_ptr<std::unordered_set<table_oid_t>> (Transaction::*)(), 5> kTableLockSetOf = {
+    &Transaction::GetSharedTableLockSet,
+    &Transaction::GetExclusiveTableLockSet,
+    &Transaction::GetIntentionSharedTableLockSet,
+    &Transaction::GetIntentionExclusiveTableLockSet,
+    &Transaction::GetSharedIntentionExclusiveTableLockSet,
+};
+
+}  // namespace
+
 auto LockManager::LockTable(Transaction *txn, LockMode lock_mode, const table_oid_t &oid) -> bool {
-  if (!CanTxnTakeLock(txn, lock_mode)) {
-    LOG_DEBUG("txn cannot take lock txn_id: %d table_oid: %u", txn->GetTransactionId(), oid);
-    return false;
+  AbortReason reason;
+  auto outcome = LockTableInternal(txn, lock_mode, oid, &reason);
+  if (LockOutcome::VIOLATION == outcome) {
+    txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
+    throw TransactionAbortException(txn->GetTransactionId(), reason);
+  }
+  return LockOutcome::SUCCESS == outcome;
+}
+
+auto LockManager::LockTableInternal(Transaction *txn, LockMode lock_mode, const table_oid_t &oid, AbortReason *reason)
+    -> LockOutcome {
+  auto can_take = CanTxnTakeLockInternal(txn, lock_mode, reason);
+  if (LockOutcome::SUCCESS != can_take) {
+    return can_take;
   }
   auto txn_id = txn->GetTransactionId();
-  std::unique_lock<std::mutex> g(table_lock_map_latch_);
-  // fresh lock
-  if (table_lock_map_.find(oid) == table_lock_map_.end()) {
-    table_lock_map_[oid] = std::make_shared<LockRequestQueue>();
+  // Fast path: if this transaction already holds exactly this mode on the table, its own lock set
+  // says so, and the lock sets are only ever touched by the owning transaction's thread. Repeated
+  // locks of the same object then return without any shard or queue latch.
+  if ((txn->*kTableLockSetOf[static_cast<uint8_t>(lock_mode)])()->count(oid) > 0) {
+    return LockOutcome::SUCCESS;
+  }
+  auto &shard = TableShardFor(oid);
+  // The shard latch only protects the oid -> queue mapping, so the common case of looking up an
+  // existing queue takes it in shared mode; only the first request for an oid creates the queue
+  // under the exclusive latch, rechecking after the upgrade. All queue state lives behind the
+  // per-queue latch, so blocking on this queue never holds up lookups of other oids in the shard.
+  LockRequestQueue *q = nullptr;
+  {
+    std::shared_lock<std::shared_mutex> map_lock(shard.latch_);
+    auto map_iter = shard.map_.find(oid);
+    if (map_iter != shard.map_.end()) {
+      q = map_iter->second.get();
+    }
+  }
+  if (nullptr == q) {
+    std::unique_lock<std::shared_mutex> map_lock(shard.latch_);
+    auto &slot = shard.map_[oid];
+    if (nullptr == slot) {
+      slot = std::make_unique<LockRequestQueue>();
+    }
+    q = slot.get();
   }
-  auto q = table_lock_map_[oid];
+  std::unique_lock<std::mutex> g(q->latch_);
   // upgrading should be proritised over other waiting lock requests
   bool is_compatible = true;
-  auto lock_request = GetLockRequest(q.get(), lock_mode, txn_id, is_compatible);
+  auto lock_request = GetLockRequest(q, lock_mode, txn_id, is_compatible);
   if (lock_request != nullptr) {
     if (lock_request->lock_mode_ == lock_mode && lock_request->granted_) {
-      return true;
+      return LockOutcome::SUCCESS;
     }
     // check if there is any txn upgrading
-    if (INVALID_TXN_ID != q->upgrading_) {  // do aborting UPGRADE_CONFLICT
-      LOG_DEBUG("do aborting UPGRADE_CONFLICT upgrading_txn:%d txn_id: %d", q->upgrading_, txn_id);
-      txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-      throw TransactionAbortException(txn_id, AbortReason::UPGRADE_CONFLICT);
+    if (INVALID_TXN_ID != q->upgrading_) {
+      *reason = AbortReason::UPGRADE_CONFLICT;
+      return LockOutcome::VIOLATION;
     }
     if (CanLockUpgrade(lock_request->lock_mode_, lock_mode)) {
       q->upgrading_ = txn_id;
       lock_request->granted_ = false;
+      q->OnRevoke(lock_request->lock_mode_);
       DeleteTxnTableLockSet(txn, lock_request->lock_mode_, oid);
       lock_request->lock_mode_ = lock_mode;
-      q->cv_.notify_all();
+      q->SyncHot(q->FindRequest(txn_id));
+      GrantNewLocksIfPossible(q);
     } else {
-      LOG_DEBUG("do aborting INCOMPATIBLE_UPGRADE");
-      txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-      throw TransactionAbortException(txn_id, AbortReason::INCOMPATIBLE_UPGRADE);
+      *reason = AbortReason::INCOMPATIBLE_UPGRADE;
+      return LockOutcome::VIOLATION;
     }
   } else {
-    lock_request = new LockRequest(txn_id, lock_mode, oid);
-    q->request_queue_.push_back(lock_request);
+    lock_request = q->AllocRequest(txn_id, lock_mode, oid);
+    q->Enqueue(lock_request);
   }
   // we shall wait
-  while (!is_compatible) {
-    // LOG_DEBUG("NOT Compatible keep waiting txn_id: %d table_oid: %u", txn_id, oid);
-    q->cv_.wait(g);
-    if (!CanTxnTakeLock(txn, lock_mode)) {  // do some cleanup
-      auto iterator = q->request_queue_.begin();
-      for (; iterator != q->request_queue_.end() && (*iterator)->txn_id_ != txn_id; ++iterator) {
+  if (!is_compatible) {
+    RefreshWaitEdges(q, lock_request);
+    // A directed wakeup arrives only after a releasing thread batch-granted this request or the
+    // deadlock detector aborted the transaction, so that pair is the wait predicate; spurious
+    // wakeups go straight back to sleep without rescanning the queue.
+    lock_request->cv_.wait(
+        g, [&] { return lock_request->granted_ || TransactionState::ABORTED == txn->GetState(); });
+    // The waker already re-ran the compatibility scan and marked us granted under the queue
+    // latch, so no CanTxnTakeLock or queue rescan is needed here. A blocked transaction cannot
+    // change its own state, so the only post-wait condition to check is an abort by the deadlock
+    // detector — and the abort check must come first, since a release may have granted us in the
+    // same window.
+    if (TransactionState::ABORTED == txn->GetState()) {  // do some cleanup
+      ClearWaitEdges(txn_id);
+      if (lock_request->granted_) {
+        // A releasing thread batch-granted us before the abort was noticed; undo its accounting.
+        lock_request->granted_ = false;
+        q->OnRevoke(lock_request->lock_mode_);
       }
-      if (iterator != q->request_queue_.end()) {
-        q->request_queue_.erase(iterator);
+      auto pos = q->FindRequest(txn_id);
+      if (pos != LockRequestQueue::INVALID_POS) {
+        q->Erase(pos);
       }
       if (txn_id == q->upgrading_) {
         q->upgrading_ = INVALID_TXN_ID;
       }
-      delete lock_request;
-      q->cv_.notify_all();
-      return false;
+      q->FreeRequest(lock_request);
+      // Wake only the waiters our departure made compatible. This must happen under the latch:
+      // once it drops, another waiter could erase and delete the request we are about to notify.
+      GrantNewLocksIfPossible(q);
+      return LockOutcome::FAILURE;
     }
-    is_compatible = true;
-    lock_request = GetLockRequest(q.get(), lock_mode, txn_id, is_compatible);
-    // LOG_DEBUG("NOT Compatible After waiting txn_id: %d table_oid: %u", txn_id, oid);
+    ClearWaitEdges(txn_id);
+  }
+  if (!lock_request->granted_) {
+    lock_request->granted_ = true;
+    q->OnGrant(lock_mode);
+    q->SyncHot(q->FindRequest(txn_id));
   }
-  lock_request->granted_ = true;
   if (txn_id == q->upgrading_) {
     q->upgrading_ = INVALID_TXN_ID;
   }
-  // LOG_DEBUG("Granted Lock txn_id: %d table_oid: %u", txn_id, oid);
   UpdateTxnTableLockSet(txn, lock_mode, oid);
-  return true;
+  return LockOutcome::SUCCESS;
 }
 
 auto LockManager::UnlockTable(Transaction *txn, const table_oid_t &oid) -> bool {
-  // find if we hold the lock
-  auto txn_id = txn->GetTransactionId();
-  // LOG_DEBUG("Before notify txn_id: %d, table_oid: %u", txn_id, oid);
-  std::unique_lock<std::mutex> g(table_lock_map_latch_);
-  auto q = table_lock_map_[oid];
-  if (nullptr == q) {
-    LOG_DEBUG("do aborting ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD");
+  AbortReason reason;
+  auto outcome = UnlockTableInternal(txn, oid, &reason);
+  if (LockOutcome::VIOLATION == outcome) {
     txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-    throw TransactionAbortException(txn->GetTransactionId(), AbortReason::ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD);
+    throw TransactionAbortException(txn->GetTransactionId(), reason);
   }
-  auto iterator = q->request_queue_.begin();
-  bool is_found = false;
-  for (; iterator != q->request_queue_.end(); ++iterator) {
-    if ((*iterator)->txn_id_ == txn_id && (*iterator)->granted_) {
-      is_found = true;
-      break;
+  return LockOutcome::SUCCESS == outcome;
+}
+
+auto LockManager::UnlockTableInternal(Transaction *txn, const table_oid_t &oid, AbortReason *reason) -> LockOutcome {
+  // find if we hold the lock
+  auto txn_id = txn->GetTransactionId();
+  auto &shard = TableShardFor(oid);
+  LockRequestQueue *q = nullptr;
+  {
+    std::shared_lock<std::shared_mutex> map_lock(shard.latch_);
+    auto map_iter = shard.map_.find(oid);
+    if (map_iter != shard.map_.end()) {
+      q = map_iter->second.get();
     }
   }
-  if (!is_found) {
-    LOG_DEBUG("do aborting ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD");
-    txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-    throw TransactionAbortException(txn->GetTransactionId(), AbortReason::ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD);
+  if (nullptr == q) {
+    *reason = AbortReason::ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD;
+    return LockOutcome::VIOLATION;
+  }
+  std::unique_lock<std::mutex> g(q->latch_);
+  auto pos = q->FindRequest(txn_id);
+  if (pos == LockRequestQueue::INVALID_POS || !q->request_queue_[pos]->granted_) {
+    *reason = AbortReason::ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD;
+    return LockOutcome::VIOLATION;
   }
   auto s_row_lock_set = txn->GetSharedRowLockSet();
   auto x_row_lock_set = txn->GetExclusiveRowLockSet();
   if (!(*s_row_lock_set)[oid].empty() || !(*x_row_lock_set)[oid].empty()) {
-    LOG_DEBUG("do aborting TABLE_UNLOCKED_BEFORE_UNLOCKING_ROWS");
-    txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-    throw TransactionAbortException(txn->GetTransactionId(), AbortReason::TABLE_UNLOCKED_BEFORE_UNLOCKING_ROWS);
+    *reason = AbortReason::TABLE_UNLOCKED_BEFORE_UNLOCKING_ROWS;
+    return LockOutcome::VIOLATION;
   }
-  auto lock_request = *iterator;
+  auto lock_request = q->request_queue_[pos];
   ChangeTxnState(txn, lock_request->lock_mode_);
-  q->request_queue_.erase(iterator);
+  q->Erase(pos);
+  q->OnRevoke(lock_request->lock_mode_);
   DeleteTxnTableLockSet(txn, lock_request->lock_mode_, oid);
-  delete lock_request;
-  if (!q->request_queue_.empty()) {
-    g.unlock();
-    q->cv_.notify_all();
-  }
-  // LOG_DEBUG("After notify Quit txn_id: %d, table_oid: %u", txn_id, oid);
-  return true;
+  q->FreeRequest(lock_request);
+  GrantNewLocksIfPossible(q);
+  return LockOutcome::SUCCESS;
 }
 
 auto LockManager::LockRow(Transaction *txn, LockMode lock_mode, const table_oid_t &oid, const RID &rid) -> bool {
-  if (!CanTxnTakeLock(txn, lock_mode)) {
-    LOG_DEBUG("txn cannot take lock txn_id: %d table_oid: %u", txn->GetTransactionId(), oid);
-    return false;
+  AbortReason reason;
+  auto outcome = LockRowInternal(txn, lock_mode, oid, rid, &reason);
+  if (LockOutcome::VIOLATION == outcome) {
+    txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
+    throw TransactionAbortException(txn->GetTransactionId(), reason);
+  }
+  return LockOutcome::SUCCESS == outcome;
+}
+
+auto LockManager::LockRowInternal(Transaction *txn, LockMode lock_mode, const table_oid_t &oid, const RID &rid,
+                                  AbortReason *reason) -> LockOutcome {
+  auto can_take = CanTxnTakeLockInternal(txn, lock_mode, reason);
+  if (LockOutcome::SUCCESS != can_take) {
+    return can_take;
   }
   auto txn_id = txn->GetTransactionId();
   // intention lock is not allowed for row!
   if (lock_mode == LockMode::INTENTION_SHARED || LockMode::SHARED_INTENTION_EXCLUSIVE == lock_mode ||
       lock_mode == LockMode::INTENTION_EXCLUSIVE) {
-    LOG_DEBUG("do aborting ATTEMPTED_INTENTION_LOCK_ON_ROW");
-    txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-    throw TransactionAbortException(txn_id, AbortReason::ATTEMPTED_INTENTION_LOCK_ON_ROW);
+    *reason = AbortReason::ATTEMPTED_INTENTION_LOCK_ON_ROW;
+    return LockOutcome::VIOLATION;
   }
   bool is_lock_table = CheckAppropriateLockOnTable(txn, oid, lock_mode);
   if (!is_lock_table) {
-    LOG_DEBUG("do aborting TABLE_LOCK_NOT_PRESENT");
-    txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-    throw TransactionAbortException(txn->GetTransactionId(), AbortReason::TABLE_LOCK_NOT_PRESENT);
+    *reason = AbortReason::TABLE_LOCK_NOT_PRESENT;
+    return LockOutcome::VIOLATION;
+  }
+  // Fast path: a held row lock that already satisfies the request (X subsumes S) is visible in
+  // the transaction's own lock sets, so re-entrant locks skip the shard and queue latches.
+  auto x_row_lock_set = txn->GetExclusiveRowLockSet();
+  auto x_iter = x_row_lock_set->find(oid);
+  if (x_iter != x_row_lock_set->end() && x_iter->second.count(rid) > 0) {
+    return LockOutcome::SUCCESS;
+  }
+  auto s_row_lock_set = txn->GetSharedRowLockSet();
+  auto s_iter = s_row_lock_set->find(oid);
+  bool holds_shared_row = s_iter != s_row_lock_set->end() && s_iter->second.count(rid) > 0;
+  if (LockMode::SHARED == lock_mode && holds_shared_row) {
+    return LockOutcome::SUCCESS;
+  }
+  // Escalation fast path: a table lock that subsumes the requested row lock makes the per-row
+  // queue pointless — any conflicting row access by another transaction would first need a table
+  // intention lock that conflicts with ours. Record the row in the lock set and return without
+  // touching the shard map or allocating a queue entry. An X request while we hold a shared
+  // record on this rid falls through so the upgrade bookkeeping below runs.
+  if (!(LockMode::EXCLUSIVE == lock_mode && holds_shared_row)) {
+    bool table_subsumes = txn->GetExclusiveTableLockSet()->count(oid) > 0;
+    if (!table_subsumes && LockMode::SHARED == lock_mode) {
+      table_subsumes = txn->GetSharedTableLockSet()->count(oid) > 0 ||
+                       txn->GetSharedIntentionExclusiveTableLockSet()->count(oid) > 0;
+    }
+    if (table_subsumes) {
+      UpdateTxnRowLockSet(txn, lock_mode, oid, rid);
+      return LockOutcome::SUCCESS;
+    }
+  }
+  auto &shard = RowShardFor(rid);
+  LockRequestQueue *q = nullptr;  // FIXME: is rid globally unique?
+  {
+    std::shared_lock<std::shared_mutex> map_lock(shard.latch_);
+    auto map_iter = shard.map_.find(rid);
+    if (map_iter != shard.map_.end()) {
+      q = map_iter->second.get();
+    }
   }
-  // LOG_DEBUG("is_lock_table ok txn_id: %d", txn->GetTransactionId());
-  std::unique_lock<std::mutex> g(row_lock_map_latch_);
-  if (row_lock_map_.find(rid) == row_lock_map_.end()) {
-    row_lock_map_[rid] = std::make_shared<LockRequestQueue>();
+  if (nullptr == q) {
+    std::unique_lock<std::shared_mutex> map_lock(shard.latch_);
+    auto &slot = shard.map_[rid];
+    if (nullptr == slot) {
+      slot = std::make_unique<LockRequestQueue>();
+    }
+    q = slot.get();
   }
-  auto q = row_lock_map_[rid];  // FIXME: is rid globally unique?
+  std::unique_lock<std::mutex> g(q->latch_);
   bool is_compatible = true;
-  auto lock_request = GetLockRequest(q.get(), lock_mode, txn_id, is_compatible);
+  auto lock_request = GetLockRequest(q, lock_mode, txn_id, is_compatible);
   if (lock_request != nullptr) {
     if (AreCurrentLockSatisfied(lock_request->lock_mode_, lock_mode) && lock_request->granted_) {
-      return true;
+      return LockOutcome::SUCCESS;
     }
     // check if there is any txn upgrading
     if (INVALID_TXN_ID != q->upgrading_) {
-      LOG_DEBUG("do aborting UPGRADE_CONFLICT upgrading_txn:%d txn_id: %d", q->upgrading_, txn_id);
-      txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-      throw TransactionAbortException(txn_id, AbortReason::UPGRADE_CONFLICT);
+      *reason = AbortReason::UPGRADE_CONFLICT;
+      return LockOutcome::VIOLATION;
     }
     // check can upgrage
     if (lock_request->lock_mode_ != lock_mode && LockMode::EXCLUSIVE != lock_mode) {
-      LOG_DEBUG("do aborting INCOMPATIBLE_UPGRADE");
-      txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-      throw TransactionAbortException(txn_id, AbortReason::INCOMPATIBLE_UPGRADE);
+      *reason = AbortReason::INCOMPATIBLE_UPGRADE;
+      return LockOutcome::VIOLATION;
     }
     q->upgrading_ = txn_id;
     lock_request->granted_ = false;
+    q->OnRevoke(lock_request->lock_mode_);
     DeleteTxnRowLockSet(txn, lock_request->lock_mode_, oid, rid);
     lock_request->lock_mode_ = lock_mode;
+    q->SyncHot(q->FindRequest(txn_id));
   } else {
-    lock_request = new LockRequest(txn_id, lock_mode, oid, rid);
-    q->request_queue_.push_back(lock_request);
+    if (LockMode::EXCLUSIVE == lock_mode && holds_shared_row) {
+      // The shared record came from the escalation fast path, so there is no queue entry to
+      // upgrade; drop it here or the grant below would leave the rid in both row lock sets.
+      DeleteTxnRowLockSet(txn, LockMode::SHARED, oid, rid);
+    }
+    lock_request = q->AllocRequest(txn_id, lock_mode, oid, rid);
+    q->Enqueue(lock_request);
   }
   // we shall wait
-  while (!is_compatible) {
-    q->cv_.wait(g);
-    // check txn status again
-    if (!CanTxnTakeLock(txn, lock_mode)) {  // do some cleanup
-      LOG_DEBUG("Cleanup Aborted txn txn_id: %d table_oid: %u", txn_id, oid);
-      auto iterator = q->request_queue_.begin();
-      for (; iterator != q->request_queue_.end() && (*iterator)->txn_id_ != txn_id; ++iterator) {
+  if (!is_compatible) {
+    RefreshWaitEdges(q, lock_request);
+    // A directed wakeup arrives only after a releasing thread batch-granted this request or the
+    // deadlock detector aborted the transaction, so that pair is the wait predicate; spurious
+    // wakeups go straight back to sleep without rescanning the queue.
+    lock_request->cv_.wait(
+        g, [&] { return lock_request->granted_ || TransactionState::ABORTED == txn->GetState(); });
+    // As in LockTableInternal: the waker granted us under the queue latch, so only an abort by
+    // the deadlock detector needs checking after the wait, and it takes priority over a grant
+    // that raced with it.
+    if (TransactionState::ABORTED == txn->GetState()) {  // do some cleanup
+      ClearWaitEdges(txn_id);
+      if (lock_request->granted_) {
+        // A releasing thread batch-granted us before the abort was noticed; undo its accounting.
+        lock_request->granted_ = false;
+        q->OnRevoke(lock_request->lock_mode_);
       }
-      if (iterator != q->request_queue_.end()) {
-        lock_request = *iterator;
-        q->request_queue_.erase(iterator);
+      auto pos = q->FindRequest(txn_id);
+      if (pos != LockRequestQueue::INVALID_POS) {
+        lock_request = q->request_queue_[pos];
+        q->Erase(pos);
       }
       if (txn_id == q->upgrading_) {
         q->upgrading_ = INVALID_TXN_ID;
       }
-      delete lock_request;
-      q->cv_.notify_all();
-      return false;
+      q->FreeRequest(lock_request);
+      // Wake only the waiters our departure made compatible. This must happen under the latch:
+      // once it drops, another waiter could erase and delete the request we are about to notify.
+      GrantNewLocksIfPossible(q);
+      return LockOutcome::FAILURE;
     }
-    // LOG_DEBUG("NOT Compatible keep waiting txn_id: %d table_oid: %u", txn_id, oid);
-    is_compatible = true;
-    lock_request = GetLockRequest(q.get(), lock_mode, txn_id, is_compatible);
+    ClearWaitEdges(txn_id);
+  }
+  if (!lock_request->granted_) {
+    lock_request->granted_ = true;
+    q->OnGrant(lock_mode);
+    q->SyncHot(q->FindRequest(txn_id));
   }
-  lock_request->granted_ = true;
   if (txn_id == q->upgrading_) {
     q->upgrading_ = INVALID_TXN_ID;
   }
   UpdateTxnRowLockSet(txn, lock_mode, oid, rid);
-  // LOG_DEBUG("Granted row lock txn_id: %d table_oid: %u", txn_id, oid);
-  return true;
+  return LockOutcome::SUCCESS;
 }
 
 auto LockManager::UnlockRow(Transaction *txn, const table_oid_t &oid, const RID &rid, bool force) -> bool {
-  // find if we hold the lock
-  auto txn_id = txn->GetTransactionId();
-  std::unique_lock<std::mutex> g(row_lock_map_latch_);
-  auto q = row_lock_map_[rid];
-  if (nullptr == q) {
-    LOG_DEBUG("do aborting ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD");
+  AbortReason reason;
+  auto outcome = UnlockRowInternal(txn, oid, rid, force, &reason);
+  if (LockOutcome::VIOLATION == outcome) {
     txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-    throw TransactionAbortException(txn->GetTransactionId(), AbortReason::ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD);
+    throw TransactionAbortException(txn->GetTransactionId(), reason);
   }
-  auto iterator = q->request_queue_.begin();
-  bool is_found = false;
-  while (iterator != q->request_queue_.end()) {
-    if ((*iterator)->txn_id_ == txn_id && (*iterator)->granted_) {
-      is_found = true;
-      break;
+  return LockOutcome::SUCCESS == outcome;
+}
+
+auto LockManager::UnlockRowInternal(Transaction *txn, const table_oid_t &oid, const RID &rid, bool force,
+                                    AbortReason *reason) -> LockOutcome {
+  // find if we hold the lock
+  auto txn_id = txn->GetTransactionId();
+  auto &shard = RowShardFor(rid);
+  LockRequestQueue *q = nullptr;
+  {
+    std::shared_lock<std::shared_mutex> map_lock(shard.latch_);
+    auto map_iter = shard.map_.find(rid);
+    if (map_iter != shard.map_.end()) {
+      q = map_iter->second.get();
+    }
+  }
+  std::unique_lock<std::mutex> g;
+  auto pos = LockRequestQueue::INVALID_POS;
+  if (q != nullptr) {
+    g = std::unique_lock<std::mutex>(q->latch_);
+    pos = q->FindRequest(txn_id);
+  }
+  bool is_found = pos != LockRequestQueue::INVALID_POS && q->request_queue_[pos]->granted_;
+  if (!is_found) {
+    // Escalation fast path: row locks recorded under a subsuming table lock have no queue entry,
+    // so release them from the transaction's lock sets alone.
+    auto fast_mode = LockMode::SHARED;
+    auto x_row_lock_set = txn->GetExclusiveRowLockSet();
+    auto x_iter = x_row_lock_set->find(oid);
+    bool holds_fast = x_iter != x_row_lock_set->end() && x_iter->second.count(rid) > 0;
+    if (holds_fast) {
+      fast_mode = LockMode::EXCLUSIVE;
+    } else {
+      auto s_row_lock_set = txn->GetSharedRowLockSet();
+      auto s_iter = s_row_lock_set->find(oid);
+      holds_fast = s_iter != s_row_lock_set->end() && s_iter->second.count(rid) > 0;
+    }
+    if (holds_fast) {
+      if (!force) {
+        ChangeTxnState(txn, fast_mode);
+      }
+      DeleteTxnRowLockSet(txn, fast_mode, oid, rid);
+      return LockOutcome::SUCCESS;
     }
-    ++iterator;
-  }
-  if (!is_found) {  // do aborting ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD
     if (!force) {
-      txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-      LOG_DEBUG("Aborted: ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD txn_id: %d", txn_id);
-      throw TransactionAbortException(txn->GetTransactionId(), AbortReason::ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD);
+      *reason = AbortReason::ATTEMPTED_UNLOCK_BUT_NO_LOCK_HELD;
+      return LockOutcome::VIOLATION;
     }
-    return true;
+    return LockOutcome::SUCCESS;
   }
-  // LOG_DEBUG("check table lock1 txn_id: %d is_found: %d", txn_id, is_found);
-  auto lock_request = *iterator;
+  auto lock_request = q->request_queue_[pos];
   bool is_lock_table = CheckAppropriateLockOnTable(txn, oid, lock_request->lock_mode_);
-  if (!force && !is_lock_table) {              // do aborting TABLE_LOCK_NOT_PRESENT
-    txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-    LOG_DEBUG("Aborted: TABLE_LOCK_NOT_PRESENT txn_id: %d", txn_id);
-    throw TransactionAbortException(txn->GetTransactionId(), AbortReason::TABLE_LOCK_NOT_PRESENT);
+  if (!force && !is_lock_table) {
+    *reason = AbortReason::TABLE_LOCK_NOT_PRESENT;
+    return LockOutcome::VIOLATION;
   }
   if (!force) {
     ChangeTxnState(txn, lock_request->lock_mode_);
   }
-  q->request_queue_.erase(iterator);
+  q->Erase(pos);
+  q->OnRevoke(lock_request->lock_mode_);
   DeleteTxnRowLockSet(txn, lock_request->lock_mode_, oid, rid);
-  delete lock_request;
-  if (!q->request_queue_.empty()) {
-    g.unlock();
-    q->cv_.notify_all();
-  }
-  // LOG_DEBUG("After notify Quit txn_id: %d, table_oid: %u", txn_id, oid);
-  return true;
+  q->FreeRequest(lock_request);
+  GrantNewLocksIfPossible(q);
+  return LockOutcome::SUCCESS;
 }
 
 auto LockManager::UpgradeLockTable(Transaction *txn, LockMode lock_mode, const table_oid_t &oid) -> bool {
@@ -275,144 +506,117 @@ auto LockManager::UpgradeLockRow(Transaction *txn, LockMode lock_mode, const tab
 }
 
 auto LockManager::AreLocksCompatible(LockMode l1, LockMode l2) -> bool {
-  switch (l1) {
-    case LockMode::INTENTION_SHARED: {  // IS -> [S, IS, IX, SIX]
-      return LockMode::INTENTION_SHARED == l2 || LockMode::INTENTION_EXCLUSIVE == l2 || LockMode::SHARED == l2 ||
-             LockMode::SHARED_INTENTION_EXCLUSIVE == l2;
-    }
-    case LockMode::SHARED: {  // S -> [IS, S]
-      return LockMode::SHARED == l2 || LockMode::INTENTION_SHARED == l2;
-    }
-    case LockMode::SHARED_INTENTION_EXCLUSIVE: {  // SIX -> [IS]
-      return LockMode::INTENTION_SHARED == l2;
-    }
-    case LockMode::INTENTION_EXCLUSIVE: {  // IX -> [IS, IX]
-      return LockMode::INTENTION_EXCLUSIVE == l2 || LockMode::INTENTION_SHARED == l2;
-    }
-    default: {  // X -> []
-      return false;
-    }
-  }
-  return false;
+  return MaskHas(kCompatible[static_cast<uint8_t>(l1)], l2);
 }
 
 // check txn state
 auto LockManager::CanTxnTakeLock(Transaction *txn, LockMode lock_mode) -> bool {
+  AbortReason reason;
+  auto outcome = CanTxnTakeLockInternal(txn, lock_mode, &reason);
+  if (LockOutcome::VIOLATION == outcome) {
+    txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
+    throw TransactionAbortException(txn->GetTransactionId(), reason);
+  }
+  return LockOutcome::SUCCESS == outcome;
+}
+
+auto LockManager::CanTxnTakeLockInternal(Transaction *txn, LockMode lock_mode, AbortReason *reason) -> LockOutcome {
   if (nullptr == txn) {
-    LOG_DEBUG("txn nullptr!");
-    return false;
+    return LockOutcome::FAILURE;
   }
   auto state = txn->GetState();
+  auto iso_level = txn->GetIsolationLevel();
+  // Fast path: one table load and a bit test. The branch cascade below only runs when the
+  // request is disallowed and we need to decide which AbortReason applies.
+  if (MaskHas(kAllowedModes[static_cast<uint8_t>(iso_level)][static_cast<uint8_t>(state)], lock_mode)) {
+    return LockOutcome::SUCCESS;
+  }
   if (TransactionState::ABORTED == state) {
-    return false;
+    return LockOutcome::FAILURE;
   }
-  auto iso_level = txn->GetIsolationLevel();
-  auto txn_id = txn->GetTransactionId();
   if (IsolationLevel::READ_UNCOMMITTED == iso_level &&
       (lock_mode == LockMode::INTENTION_SHARED || LockMode::SHARED == lock_mode ||
        LockMode::SHARED_INTENTION_EXCLUSIVE == lock_mode)) {
-    LOG_DEBUG("do aborting LOCK_SHARED_ON_READ_UNCOMMITTED");
-    txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-    throw TransactionAbortException(txn_id, AbortReason::LOCK_SHARED_ON_READ_UNCOMMITTED);
+    *reason = AbortReason::LOCK_SHARED_ON_READ_UNCOMMITTED;
+    return LockOutcome::VIOLATION;
   }
   // READ_UNCOMMITTED: X, IX locks are allowed in the GROWING state.
   if (IsolationLevel::READ_UNCOMMITTED == iso_level && state != TransactionState::GROWING &&
       (LockMode::EXCLUSIVE == lock_mode || LockMode::INTENTION_EXCLUSIVE == lock_mode)) {
-    LOG_DEBUG("do aborting LOCK_ON_SHRINKING");
-    txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-    throw TransactionAbortException(txn_id, AbortReason::LOCK_ON_SHRINKING);
+    *reason = AbortReason::LOCK_ON_SHRINKING;
+    return LockOutcome::VIOLATION;
   }
   // READ_COMMITTED: Only IS, S locks are allowed in the SHRINGKING state
   if (IsolationLevel::READ_COMMITTED == iso_level && state == TransactionState::SHRINKING &&
       LockMode::SHARED != lock_mode && LockMode::INTENTION_SHARED != lock_mode) {
-    LOG_DEBUG("READ_COMMITTED LOCK_ON_SHRINKING");
-    txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-    throw TransactionAbortException(txn_id, AbortReason::LOCK_ON_SHRINKING);
+    *reason = AbortReason::LOCK_ON_SHRINKING;
+    return LockOutcome::VIOLATION;
   }
   // REPEATABLE_READ: No locks are allowed in the SHRINKING state
   if (IsolationLevel::REPEATABLE_READ == iso_level && state == TransactionState::SHRINKING) {
-    LOG_DEBUG("do aborting LOCK_ON_SHRINKING");
-    txn->SetState(TransactionState::ABORTED);  // FIXME: shall we set aborted w/out release locks ?
-    throw TransactionAbortException(txn_id, AbortReason::LOCK_ON_SHRINKING);
+    *reason = AbortReason::LOCK_ON_SHRINKING;
+    return LockOutcome::VIOLATION;
   }
-  return true;
+  return LockOutcome::SUCCESS;
 }
 
-void LockManager::GrantNewLocksIfPossible(LockRequestQueue *lock_request_queue) {}
-
-// Note: if curr_lock_mode == requested_lock_mode return false; please do some precheck first
-auto LockManager::CanLockUpgrade(LockMode curr_lock_mode, LockMode requested_lock_mode) -> bool {
-  switch (curr_lock_mode) {
-    case LockMode::INTENTION_SHARED: {  // IS -> [S, X, IX, SIX]
-      return LockMode::INTENTION_EXCLUSIVE == requested_lock_mode || LockMode::SHARED == requested_lock_mode ||
-             LockMode::SHARED_INTENTION_EXCLUSIVE == requested_lock_mode || LockMode::EXCLUSIVE == requested_lock_mode;
-    }
-    case LockMode::SHARED:
-    case LockMode::INTENTION_EXCLUSIVE: {  // IX -> [X, SIX] || S -> [X, SIX]
-      return LockMode::EXCLUSIVE == requested_lock_mode || LockMode::SHARED_INTENTION_EXCLUSIVE == requested_lock_mode;
-    }
-    case LockMode::SHARED_INTENTION_EXCLUSIVE: {  // SIX -> [X]
-      return LockMode::EXCLUSIVE == requested_lock_mode;
+void LockManager::GrantNewLocksIfPossible(LockRequestQueue *lock_request_queue) {
+  // Batch grant: walk the queue once in FIFO order and grant every waiter that is compatible,
+  // updating the granted accounting as we go so each decision sees the grants made earlier in
+  // this same pass. Each granted waiter gets a directed notify_one and, on waking, finds
+  // granted_ already set, so N shared waiters behind a released exclusive lock are granted in
+  // one pass instead of N serialized wake/recheck rounds. Waiters still update their own
+  // transaction's lock sets. Must be called with the queue latch held.
+  for (size_t pos = 0; pos < lock_request_queue->request_queue_.size(); ++pos) {
+    auto *lq = lock_request_queue->request_queue_[pos];
+    if (lq->granted_) {
+      continue;
     }
-    default: {
-      return false;
+    bool is_compatible = true;
+    GetLockRequest(lock_request_queue, lq->lock_mode_, lq->txn_id_, is_compatible);
+    if (is_compatible) {
+      lq->granted_ = true;
+      lock_request_queue->OnGrant(lq->lock_mode_);
+      lock_request_queue->SyncHot(pos);
+      lq->cv_.notify_one();
     }
   }
-  return false;
+}
+
+// Note: if curr_lock_mode == requested_lock_mode return false; please do some precheck first
+auto LockManager::CanLockUpgrade(LockMode curr_lock_mode, LockMode requested_lock_mode) -> bool {
+  return MaskHas(kUpgrade[static_cast<uint8_t>(curr_lock_mode)], requested_lock_mode);
 }
 
 // if current lock satisfied, no need to regain lock
 auto LockManager::AreCurrentLockSatisfied(LockMode curr_lock_mode, LockMode requested_lock_mode) -> bool {
-  switch (curr_lock_mode) {
-    case LockMode::INTENTION_SHARED: {  // IS -> [IS]
-      return LockMode::INTENTION_SHARED == requested_lock_mode;
-    }
-    case LockMode::SHARED: {  // S -> [IS, S]
-      return LockMode::INTENTION_SHARED == requested_lock_mode || LockMode::SHARED == requested_lock_mode;
-    }
-    case LockMode::INTENTION_EXCLUSIVE: {  // IX -> [IS, IX]
-      return LockMode::INTENTION_EXCLUSIVE == requested_lock_mode || LockMode::INTENTION_SHARED == requested_lock_mode;
-    }
-    case LockMode::SHARED_INTENTION_EXCLUSIVE: {  // SIX -> [IX, SIX, S, IS]
-      return LockMode::INTENTION_SHARED == requested_lock_mode || LockMode::SHARED == requested_lock_mode ||
-             LockMode::SHARED_INTENTION_EXCLUSIVE == requested_lock_mode ||
-             LockMode::INTENTION_SHARED == requested_lock_mode;
-    }
-    case LockMode::EXCLUSIVE: {  // X -> [X, IX, SIX, S, IS]
-      return LockMode::INTENTION_SHARED == requested_lock_mode || LockMode::SHARED == requested_lock_mode ||
-             LockMode::SHARED_INTENTION_EXCLUSIVE == requested_lock_mode ||
-             LockMode::EXCLUSIVE == requested_lock_mode || LockMode::INTENTION_SHARED == requested_lock_mode;
-    }
-    default: {
-      return false;
-    }
-  }
-  return false;
+  return MaskHas(kSatisfied[static_cast<uint8_t>(curr_lock_mode)], requested_lock_mode);
 }
 
 auto LockManager::CheckAppropriateLockOnTable(Transaction *txn, const table_oid_t &oid, LockMode row_lock_mode)
     -> bool {
-  std::unique_lock<std::mutex> g(table_lock_map_latch_);
-  if (table_lock_map_.find(oid) == table_lock_map_.end()) {
+  auto &shard = TableShardFor(oid);
+  LockRequestQueue *q = nullptr;
+  {
+    std::shared_lock<std::shared_mutex> map_lock(shard.latch_);
+    auto map_iter = shard.map_.find(oid);
+    if (map_iter != shard.map_.end()) {
+      q = map_iter->second.get();
+    }
+  }
+  if (nullptr == q) {
     return false;
   }
-  auto &q = table_lock_map_[oid];
+  std::unique_lock<std::mutex> g(q->latch_);
   auto txn_id = txn->GetTransactionId();
-  auto iterator = q->request_queue_.begin();
-  while (iterator != q->request_queue_.end()) {
-    if ((*iterator)->txn_id_ == txn_id && (*iterator)->granted_) {
-      break;
-    }
-    ++iterator;
-  }
-  if (iterator == q->request_queue_.end()) {
+  auto pos = q->FindRequest(txn_id);
+  if (pos == LockRequestQueue::INVALID_POS || !q->request_queue_[pos]->granted_) {
     LOG_DEBUG("CheckAppropriateLockOnTable Not Found txn_id: %d", txn_id);
     return false;
   }
-  auto cur_lock_mode = (*iterator)->lock_mode_;
+  auto cur_lock_mode = q->request_queue_[pos]->lock_mode_;
   if (row_lock_mode == LockMode::EXCLUSIVE) {  // X -> X IX SIX
-    return LockMode::INTENTION_EXCLUSIVE == cur_lock_mode || LockMode::EXCLUSIVE == cur_lock_mode ||
-           LockMode::SHARED_INTENTION_EXCLUSIVE == cur_lock_mode;
+    return MaskHas(kRowExclusiveTableModes, cur_lock_mode);
   }
   // S -> S IS X IX SIX
   return row_lock_mode == LockMode::SHARED;
@@ -437,86 +641,76 @@ auto LockManager::GetLockRequest(LockRequestQueue *lock_request_queue, LockMode
   if (nullptr == lock_request_queue) {
     return nullptr;
   }
-  LockRequest *lock_request = nullptr;
-  for (auto lq : lock_request_queue->request_queue_) {
-    if (lq->txn_id_ == txn_id) {
-      lock_request = lq;
-      continue;
-    }
-    if (!AreLocksCompatible(lq->lock_mode_, lock_mode) && (lock_request == nullptr || lq->granted_)) {
-      is_compatible = false;
-    }
-    if (!is_compatible && lock_request != nullptr) {
-      break;
-    }
+  // The self-request is a hash lookup. Compatibility against every granted request collapses to
+  // one test of granted_mask_; the queue is walked only up to the self-request, to honor FIFO
+  // ordering against earlier waiters. The walk reads the packed hot entries, not the requests.
+  auto self = lock_request_queue->FindRequest(txn_id);
+  LockRequest *lock_request =
+      self == LockRequestQueue::INVALID_POS ? nullptr : lock_request_queue->request_queue_[self];
+  uint8_t granted_mask = lock_request_queue->granted_mask_;
+  if (lock_request != nullptr && lock_request->granted_ &&
+      lock_request_queue->granted_count_[static_cast<uint8_t>(lock_request->lock_mode_)] == 1) {
+    // Our own grant is the only one of its mode; it must not conflict with our new request.
+    granted_mask &= static_cast<uint8_t>(~ModeBit(lock_request->lock_mode_));
+  }
+  if ((granted_mask & static_cast<uint8_t>(~kCompatible[static_cast<uint8_t>(lock_mode)])) != 0) {
+    is_compatible = false;
+    return lock_request;
+  }
+  // Branchless pass over the packed flags bytes: accumulate the union of mode-bit masks blocked
+  // by every still-waiting entry ahead of us, then test our own mode bit once at the end. The
+  // all-arithmetic loop body over a dense byte array is what lets the compiler vectorize it.
+  size_t limit = self == LockRequestQueue::INVALID_POS ? lock_request_queue->hot_flags_.size() : self;
+  uint8_t blocked_modes = 0;
+  for (size_t i = 0; i < limit; ++i) {
+    const uint8_t flags = lock_request_queue->hot_flags_[i];
+    // 0xFF while the granted bit (bit 7) is clear, 0x00 once set.
+    const auto waiting = static_cast<uint8_t>(static_cast<int8_t>(~flags) >> 7);
+    blocked_modes |= static_cast<uint8_t>(~kCompatible[flags & LockRequestQueue::MODE_MASK]) & waiting;
+  }
+  if (MaskHas(blocked_modes, lock_mode)) {
+    is_compatible = false;
   }
   return lock_request;
 }
 
-auto LockManager::FindCycle(txn_id_t source_txn, std::vector<txn_id_t> &path, std::unordered_set<txn_id_t> &on_path,
-                            std::unordered_set<txn_id_t> &visited, txn_id_t *abort_txn_id) -> bool {
-  return false;
-}
-
 void LockManager::UnlockAll() {
   // You probably want to unlock all table and txn locks here.
   // Cleanup all locks
-  std::unique_lock<std::mutex> table_lock(table_lock_map_latch_);
-  for (auto &table_lock_pair : table_lock_map_) {
-    auto q = table_lock_pair.second;
-    if (nullptr == q) {
-      continue;
-    }
-    for (auto iter : q->request_queue_) {
-      delete iter;
+  for (auto &shard : table_lock_shards_) {
+    std::shared_lock<std::shared_mutex> table_lock(shard.latch_);
+    for (auto &table_lock_pair : shard.map_) {
+      auto *q = table_lock_pair.second.get();
+      if (nullptr == q) {
+        continue;
+      }
+      std::lock_guard<std::mutex> queue_lock(q->latch_);
+      for (auto iter : q->request_queue_) {
+        delete iter;
+      }
+      q->Clear();
     }
-    q->request_queue_.clear();
   }
-  table_lock.unlock();
-  std::unique_lock<std::mutex> row_lock(row_lock_map_latch_);
-  for (auto &row_lock_pair : row_lock_map_) {
-    auto q = row_lock_pair.second;
-    if (nullptr == q) {
-      continue;
-    }
-    for (auto iter : q->request_queue_) {
-      delete iter;
+  for (auto &shard : row_lock_shards_) {
+    std::shared_lock<std::shared_mutex> row_lock(shard.latch_);
+    for (auto &row_lock_pair : shard.map_) {
+      auto *q = row_lock_pair.second.get();
+      if (nullptr == q) {
+        continue;
+      }
+      std::lock_guard<std::mutex> queue_lock(q->latch_);
+      for (auto iter : q->request_queue_) {
+        delete iter;
+      }
+      q->Clear();
     }
-    q->request_queue_.clear();
   }
 }
 
 // Update txn set after grant table lock successfully.
 void LockManager::UpdateTxnTableLockSet(Transaction *txn, LockMode lock_mode, const table_oid_t &oid) {
-  switch (lock_mode) {
-    case LockMode::INTENTION_SHARED: {
-      auto is_table_lock_set = txn->GetIntentionSharedTableLockSet();
-      is_table_lock_set->emplace(oid);
-      return;
-    }
-    case LockMode::SHARED: {
-      auto s_table_lock_set = txn->GetSharedTableLockSet();
-      s_table_lock_set->emplace(oid);
-      return;
-    }
-    case LockMode::INTENTION_EXCLUSIVE: {
-      auto ix_table_lock_set = txn->GetIntentionExclusiveTableLockSet();
-      ix_table_lock_set->emplace(oid);
-      return;
-    }
-    case LockMode::SHARED_INTENTION_EXCLUSIVE: {
-      auto six_table_lock_set = txn->GetSharedIntentionExclusiveTableLockSet();
-      six_table_lock_set->emplace(oid);
-      return;
-    }
-    case LockMode::EXCLUSIVE: {
-      auto x_table_lock_set = txn->GetExclusiveTableLockSet();
-      x_table_lock_set->emplace(oid);
-      return;
-    }
-    default: {
-      return;
-    }
+  if ((txn->*kTableLockSetOf[static_cast<uint8_t>(lock_mode)])()->emplace(oid).second) {
+    txn->IncHeldLocks();
   }
 }
 
@@ -525,12 +719,16 @@ void LockManager::UpdateTxnRowLockSet(Transaction *txn, LockMode lock_mode, cons
   switch (lock_mode) {
     case LockMode::SHARED: {
       auto s_row_lock_set = txn->GetSharedRowLockSet();
-      (*s_row_lock_set)[oid].emplace(rid);
+      if ((*s_row_lock_set)[oid].emplace(rid).second) {
+        txn->IncHeldLocks();
+      }
       return;
     }
     case LockMode::EXCLUSIVE: {
       auto x_row_lock_set = txn->GetExclusiveRowLockSet();
-      (*x_row_lock_set)[oid].emplace(rid);
+      if ((*x_row_lock_set)[oid].emplace(rid).second) {
+        txn->IncHeldLocks();
+      }
       return;
     }
     default: {
@@ -540,35 +738,8 @@ void LockManager::UpdateTxnRowLockSet(Transaction *txn, LockMode lock_mode, cons
 }
 
 void LockManager::DeleteTxnTableLockSet(Transaction *txn, LockMode lock_mode, const table_oid_t &oid) {
-  switch (lock_mode) {
-    case LockMode::INTENTION_SHARED: {
-      auto is_table_lock_set = txn->GetIntentionSharedTableLockSet();
-      is_table_lock_set->erase(oid);
-      return;
-    }
-    case LockMode::SHARED: {
-      auto s_table_lock_set = txn->GetSharedTableLockSet();
-      s_table_lock_set->erase(oid);
-      return;
-    }
-    case LockMode::INTENTION_EXCLUSIVE: {
-      auto ix_table_lock_set = txn->GetIntentionExclusiveTableLockSet();
-      ix_table_lock_set->erase(oid);
-      return;
-    }
-    case LockMode::SHARED_INTENTION_EXCLUSIVE: {
-      auto six_table_lock_set = txn->GetSharedIntentionExclusiveTableLockSet();
-      six_table_lock_set->erase(oid);
-      return;
-    }
-    case LockMode::EXCLUSIVE: {
-      auto x_table_lock_set = txn->GetExclusiveTableLockSet();
-      x_table_lock_set->erase(oid);
-      return;
-    }
-    default: {
-      return;
-    }
+  if ((txn->*kTableLockSetOf[static_cast<uint8_t>(lock_mode)])()->erase(oid) > 0) {
+    txn->DecHeldLocks();
   }
 }
 
@@ -576,12 +747,16 @@ void LockManager::DeleteTxnRowLockSet(Transaction *txn, LockMode lock_mode, cons
   switch (lock_mode) {
     case LockMode::SHARED: {
       auto s_row_lock_set = txn->GetSharedRowLockSet();
-      (*s_row_lock_set)[oid].erase(rid);
+      if ((*s_row_lock_set)[oid].erase(rid) > 0) {
+        txn->DecHeldLocks();
+      }
       return;
     }
     case LockMode::EXCLUSIVE: {
       auto x_row_lock_set = txn->GetExclusiveRowLockSet();
-      (*x_row_lock_set)[oid].erase(rid);
+      if ((*x_row_lock_set)[oid].erase(rid) > 0) {
+        txn->DecHeldLocks();
+      }
       return;
     }
     default: {
@@ -589,49 +764,90 @@ void LockManager::DeleteTxnRowLockSet(Transaction *txn, LockMode lock_mode, cons
     }
   }
 }
+namespace {
+
+/** @brief Insert t into a sorted adjacency vector, keeping it sorted and deduplicated. */
+void InsertEdge(std::vector<txn_id_t> *adjacency, txn_id_t t) {
+  auto pos = std::lower_bound(adjacency->begin(), adjacency->end(), t);
+  if (pos == adjacency->end() || *pos != t) {
+    adjacency->insert(pos, t);
+  }
+}
+
+}  // namespace
+
 void LockManager::AddEdge(txn_id_t t1, txn_id_t t2) {
   std::lock_guard<std::mutex> g(waits_for_latch_);
-  auto &v = waits_for_[t1];
-  // auto txn = txn_manager_->GetTransaction(t2);
-  // auto iterator = std::find(v.begin(), v.end(), t2);
-  v.insert(t2);
+  InsertEdge(&waits_for_[t1], t2);
 }
 
 void LockManager::RemoveEdge(txn_id_t t1, txn_id_t t2) {
   std::lock_guard<std::mutex> g(waits_for_latch_);
   auto &v = waits_for_[t1];
-  auto iterator = std::find(v.begin(), v.end(), t2);
-  if (iterator != v.end()) {
+  auto iterator = std::lower_bound(v.begin(), v.end(), t2);
+  if (iterator != v.end() && *iterator == t2) {
     v.erase(iterator);
   }
 }
 
+auto LockManager::FindCycle(txn_id_t source_txn, std::vector<txn_id_t> &path, std::unordered_set<txn_id_t> &on_path,
+                            std::unordered_set<txn_id_t> &visited, txn_id_t *abort_txn_id) -> bool {
+  // Iterative DFS with an explicit stack of (node, next neighbor index). A cycle exists iff a
+  // back edge reaches a node still on the current path; a merely-visited node only means two
+  // transactions share a successor, which the old check misreported as a cycle.
+  path.clear();
+  on_path.clear();
+  std::stack<std::pair<txn_id_t, size_t>> dfs;
+  dfs.emplace(source_txn, 0);
+  path.push_back(source_txn);
+  on_path.insert(source_txn);
+  visited.insert(source_txn);
+  while (!dfs.empty()) {
+    auto &[cur, next_idx] = dfs.top();
+    auto adjacency = waits_for_.find(cur);
+    if (adjacency == waits_for_.end() || next_idx >= adjacency->second.size()) {
+      on_path.erase(cur);
+      path.pop_back();
+      dfs.pop();
+      continue;
+    }
+    auto next = adjacency->second[next_idx++];
+    if (on_path.count(next) > 0) {
+      // Back edge: the cycle is the path suffix starting at next; abort its youngest member.
+      txn_id_t youngest = next;
+      for (auto iter = path.rbegin(); iter != path.rend() && *iter != next; ++iter) {
+        youngest = std::max(youngest, *iter);
+      }
+      *abort_txn_id = youngest;
+      return true;
+    }
+    if (visited.count(next) == 0) {
+      visited.insert(next);
+      on_path.insert(next);
+      path.push_back(next);
+      dfs.emplace(next, 0);
+    }
+  }
+  return false;
+}
+
 auto LockManager::HasCycle(txn_id_t *txn_id) -> bool {
   std::lock_guard<std::mutex> g(waits_for_latch_);
-  // DFS
-  std::set<txn_id_t> d;
-  std::set<txn_id_t> visited;
   if (waits_for_.empty()) {
     LOG_DEBUG("Waits_for empty");
     return false;
   }
+  std::vector<txn_id_t> path;
+  std::unordered_set<txn_id_t> on_path;
+  std::unordered_set<txn_id_t> visited;
+  // waits_for_ keys are in ascending txn id order, so detection is deterministic.
   for (const auto &wait_for_pair : waits_for_) {
-    d.insert(wait_for_pair.first);
-  }
-  while (!d.empty()) {
-    auto cur_txn_id = *d.begin();
-    d.erase(d.begin());
-    for (auto waits_for_txn_id : waits_for_[cur_txn_id]) {
-      if (visited.find(waits_for_txn_id) == visited.end()) {
-        LOG_DEBUG("cur_txn_id(%d) waits for waits_for_txn_id(%d)", cur_txn_id, waits_for_txn_id);
-        d.insert(waits_for_txn_id);
-      } else {  // waits_for_ is sorted, the latter one must be the youngest transaction!
-        LOG_DEBUG("cur_txn_id(%d) waits for waits_for_txn_id(%d) which is visited", cur_txn_id, waits_for_txn_id);
-        *txn_id = cur_txn_id;
-        return true;
-      }
+    if (visited.count(wait_for_pair.first) > 0) {
+      continue;
+    }
+    if (FindCycle(wait_for_pair.first, path, on_path, visited, txn_id)) {
+      return true;
     }
-    visited.insert(cur_txn_id);
   }
   LOG_DEBUG("No cycle is found size: %zu", waits_for_.size());
   return false;
@@ -642,6 +858,35 @@ void LockManager::RemoveWaitsForKey(txn_id_t txn_id) {
   waits_for_.erase(txn_id);
 }
 
+void LockManager::RefreshWaitEdges(LockRequestQueue *lock_request_queue, LockRequest *waiter) {
+  std::lock_guard<std::mutex> g(waits_for_latch_);
+  auto &adjacency = waits_for_[waiter->txn_id_];
+  adjacency.clear();
+  // The blockers mirror GetLockRequest's decision: every incompatible granted request, plus
+  // every incompatible request still queued ahead of the waiter.
+  bool ahead = true;
+  for (size_t i = 0; i < lock_request_queue->hot_txn_ids_.size(); ++i) {
+    if (lock_request_queue->hot_txn_ids_[i] == waiter->txn_id_) {
+      ahead = false;
+      continue;
+    }
+    const uint8_t flags = lock_request_queue->hot_flags_[i];
+    if (MaskHas(kCompatible[flags & LockRequestQueue::MODE_MASK], waiter->lock_mode_)) {
+      continue;
+    }
+    if ((flags & LockRequestQueue::GRANTED_BIT) != 0 || ahead) {
+      InsertEdge(&adjacency, lock_request_queue->hot_txn_ids_[i]);
+    }
+  }
+  waiting_on_[waiter->txn_id_] = lock_request_queue;
+}
+
+void LockManager::ClearWaitEdges(txn_id_t txn_id) {
+  std::lock_guard<std::mutex> g(waits_for_latch_);
+  waits_for_.erase(txn_id);
+  waiting_on_.erase(txn_id);
+}
+
 auto LockManager::GetEdgeList() -> std::vector<std::pair<txn_id_t, txn_id_t>> {
   std::lock_guard<std::mutex> g(waits_for_latch_);
   std::vector<std::pair<txn_id_t, txn_id_t>> edges;
@@ -653,74 +898,38 @@ auto LockManager::GetEdgeList() -> std::vector<std::pair<txn_id_t, txn_id_t>> {
   return edges;
 }
 
-void LockManager::BuildGraph() {
-  std::lock_guard<std::mutex> g(waits_for_latch_);
-  // LOG_DEBUG("BuildGraph from empty");
-  waits_for_.clear();
-  // build waits for graph by traversing lock_request_queue
-  std::unique_lock<std::mutex> table_lock(table_lock_map_latch_);
-  for (const auto &table_lock_pair : table_lock_map_) {
-    const auto &q = table_lock_pair.second;
-    if (nullptr != q) {
-      std::set<txn_id_t> waits_for;
-      for (const auto &iter : q->request_queue_) {
-        auto txn = txn_manager_->GetTransaction(iter->txn_id_);
-        if (nullptr == txn) {
-          continue;
-        }
-        if (TransactionState::ABORTED == txn->GetState()) {  // wakeup and do some cleanup
-          LOG_DEBUG("Aborted txn_id: %d wakeup", iter->txn_id_);
-          q->cv_.notify_all();
-          continue;
-        }
-        if (!iter->granted_) {
-          waits_for_[iter->txn_id_] = waits_for;
-        }
-        waits_for.insert(iter->txn_id_);
-      }
-    }
-  }
-  table_lock.unlock();
-  std::unique_lock<std::mutex> row_lock(row_lock_map_latch_);
-  for (const auto &row_lock_pair : row_lock_map_) {
-    const auto &q = row_lock_pair.second;
-    if (nullptr != q) {
-      std::set<txn_id_t> waits_for;
-      for (const auto &iter : q->request_queue_) {
-        auto txn = txn_manager_->GetTransaction(iter->txn_id_);
-        if (nullptr == txn) {
-          continue;
-        }
-        if (TransactionState::ABORTED == txn->GetState()) {  // wakeup and do some cleanup
-          LOG_DEBUG("Aborted txn_id: %d wakeup", iter->txn_id_);
-          q->cv_.notify_all();
-          continue;
-        }
-        if (!iter->granted_) {
-          for (const auto &waits_for_txn_id : waits_for) {
-            waits_for_[iter->txn_id_].insert(waits_for_txn_id);
-          }
-        }
-        waits_for.insert(iter->txn_id_);
-      }
-    }
-  }
-}
-
 void LockManager::RunCycleDetection() {
   while (enable_cycle_detection_) {
     std::this_thread::sleep_for(cycle_detection_interval);
     {  // TODO(students): detect deadlock
       txn_id_t abort_txn_id = INVALID_TXN_ID;
-      // make sure there is no cycle remained!
-      BuildGraph();
+      // The waits-for graph is maintained incrementally by the waiters themselves
+      // (RefreshWaitEdges before each block, ClearWaitEdges on grant or cleanup), so a detection
+      // round is just the cycle search: no rescan of every lock queue with its latch held.
       while (HasCycle(&abort_txn_id)) {
-        // LOG_DEBUG("HasCycle txn_id: %d!", abort_txn_id);
         auto txn = txn_manager_->GetTransaction(abort_txn_id);
         if (nullptr != txn) {
-          // LOG_DEBUG("HasCycle abort_xn_id: %d!", abort_txn_id);
           txn->SetState(TransactionState::ABORTED);
-          RemoveWaitsForKey(abort_txn_id);
+        }
+        LockRequestQueue *q = nullptr;
+        {
+          std::lock_guard<std::mutex> graph_lock(waits_for_latch_);
+          auto iter = waiting_on_.find(abort_txn_id);
+          if (iter != waiting_on_.end()) {
+            q = iter->second;
+          }
+          waits_for_.erase(abort_txn_id);
+          waiting_on_.erase(abort_txn_id);
+        }
+        if (nullptr != q) {
+          // Wake the victim so it observes the abort and cleans its request out of the queue.
+          // Taken after waits_for_latch_ is dropped, so the latch order never inverts against
+          // RefreshWaitEdges, which runs under the queue latch.
+          std::lock_guard<std::mutex> queue_lock(q->latch_);
+          auto pos = q->FindRequest(abort_txn_id);
+          if (pos != LockRequestQueue::INVALID_POS) {
+            q->request_queue_[pos]->cv_.notify_one();
+          }
         }
       }
     }
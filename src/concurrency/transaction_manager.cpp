@@ -23,8 +23,11 @@
 namespace bustub {
 
 void TransactionManager::Commit(Transaction *txn) {
-  // Release all the locks.
-  ReleaseLocks(txn);
+  // Release all the locks. A transaction holding none (read-only, or everything force-unlocked
+  // already) skips the release walk and its latching outright.
+  if (txn->GetHeldLocks() != 0) {
+    ReleaseLocks(txn);
+  }
 
   txn->SetState(TransactionState::COMMITTED);
 }
@@ -33,41 +36,46 @@ void TransactionManager::Abort(Transaction *txn) {
   /* TODO: revert all the changes in write set */
   RevertWriteSet(txn);
 
-  ReleaseLocks(txn);
+  if (txn->GetHeldLocks() != 0) {
+    ReleaseLocks(txn);
+  }
 
   txn->SetState(TransactionState::ABORTED);
 }
 
 void TransactionManager::RevertWriteSet(Transaction *txn) {
+  // Read a record this many slots ahead of the one being reverted.
+  constexpr size_t PREFETCH_DISTANCE = 4;
   txn->LockTxn();
   auto table_write_set = txn->GetWriteSet();
   auto index_write_set = txn->GetIndexWriteSet();
-  while (!table_write_set->empty()) {
-    auto record = table_write_set->back();
-    table_write_set->pop_back();
-    if (WType::INSERT == record.wtype_) {
-      record.table_heap_->UpdateTupleMeta(TupleMeta{txn->GetTransactionId(), txn->GetTransactionId(), true},
-                                          record.rid_);
-    } else if (WType::DELETE == record.wtype_) {
-      record.table_heap_->UpdateTupleMeta(TupleMeta{txn->GetTransactionId(), txn->GetTransactionId(), false},
-                                          record.rid_);
+  auto txn_id = txn->GetTransactionId();
+  // Walk the table write set back to front in place instead of pop_back-ing one record at a time.
+  // The two revert cases write the same meta apart from the tombstone flag (an INSERT is undone
+  // by deleting, a DELETE by resurrecting), so the flag is computed rather than branched on; the
+  // record a few slots ahead is prefetched because every UpdateTupleMeta drags a random heap page
+  // through the cache before the next record is read.
+  for (auto i = static_cast<ptrdiff_t>(table_write_set->size()) - 1; i >= 0; --i) {
+    if (i >= static_cast<ptrdiff_t>(PREFETCH_DISTANCE)) {
+      __builtin_prefetch(&(*table_write_set)[i - PREFETCH_DISTANCE]);
     }
+    const auto &record = (*table_write_set)[i];
+    record.table_heap_->UpdateTupleMeta(TupleMeta{txn_id, txn_id, WType::INSERT == record.wtype_}, record.rid_);
   }
-  while (!index_write_set->empty()) {
-    auto record = index_write_set->back();
-    index_write_set->pop_back();
+  table_write_set->clear();
+  // The records store the already-projected index key in the transaction's arena, so reverting
+  // needs neither the table metadata nor a KeyFromTuple re-projection.
+  for (auto i = static_cast<ptrdiff_t>(index_write_set->size()) - 1; i >= 0; --i) {
+    const auto &record = (*index_write_set)[i];
     auto index_info = record.catalog_->GetIndex(record.index_oid_);
-    auto table_info = record.catalog_->GetTable(record.table_oid_);
+    auto key = txn->GetIndexWriteKey(record);
     if (WType::INSERT == record.wtype_) {
-      index_info->index_->DeleteEntry(
-          record.tuple_.KeyFromTuple(table_info->schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs()),
-          record.rid_, txn);
+      index_info->index_->DeleteEntry(key, record.rid_, txn);
     } else if (WType::DELETE == record.wtype_) {
-      index_info->index_->InsertEntry(
-          record.tuple_.KeyFromTuple(table_info->schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs()),
-          record.rid_, txn);
+      index_info->index_->InsertEntry(key, record.rid_, txn);
     }
   }
+  txn->ClearIndexWriteSet();
   txn->UnlockTxn();
 }
 void TransactionManager::BlockAllTransactions() { UNIMPLEMENTED("block is not supported now!"); }
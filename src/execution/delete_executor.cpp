@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <memory>
 
 #include "execution/executors/delete_executor.h"
@@ -20,15 +21,33 @@ DeleteExecutor::DeleteExecutor(ExecutorContext *exec_ctx, const DeletePlanNode *
                                std::unique_ptr<AbstractExecutor> &&child_executor)
     : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
 
-void DeleteExecutor::Init() { child_executor_->Init(); }
+void DeleteExecutor::Init() {
+  child_executor_->Init();
+  // Resolve the catalog entries once; Next() loops over tuples and must not re-probe the catalog
+  // hash maps (or re-copy key attributes) per row.
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
+  auto index_info_vec = exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_);
+  // Group the indexes by identical key attributes: equal attrs over the same table schema project
+  // to equivalent keys, so one KeyFromTuple per group per tuple serves every index in the group.
+  key_groups_.clear();
+  for (auto index_info : index_info_vec) {
+    const auto &key_attrs = index_info->index_->GetKeyAttrs();
+    auto it = std::find_if(key_groups_.begin(), key_groups_.end(),
+                           [&key_attrs](const IndexKeyGroup &group) { return group.key_attrs_ == key_attrs; });
+    if (key_groups_.end() == it) {
+      key_groups_.push_back(IndexKeyGroup{key_attrs, &index_info->key_schema_, {}});
+      it = std::prev(key_groups_.end());
+    }
+    it->indexes_.push_back(index_info);
+  }
+}
 
 auto DeleteExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   if (is_excuted_) {
     return false;
   }
   int cnt = 0;
-  auto table_info = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
-  auto index_info_vec = exec_ctx_->GetCatalog()->GetTableIndexes(table_info->name_);
+  auto table_info = table_info_;
   auto txn = exec_ctx_->GetTransaction();
   while (true) {
     bool res = child_executor_->Next(tuple, rid);
@@ -40,16 +59,18 @@ auto DeleteExecutor::Next(Tuple *tuple, RID *rid) -> bool {
     TableWriteRecord write_record(table_info->oid_, *rid, table_info->table_.get());
     write_record.wtype_ = WType::DELETE;
     txn->AppendTableWriteRecord(write_record);
-    for (auto index_info : index_info_vec) {
-      index_info->index_->DeleteEntry(
-          tuple->KeyFromTuple(table_info->schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs()), *rid,
-          txn);
-      txn->AppendIndexWriteRecord(IndexWriteRecord(*rid, table_info->oid_, WType::DELETE, *tuple,
-                                                   index_info->index_oid_, exec_ctx_->GetCatalog()));
+    for (const auto &group : key_groups_) {
+      auto key = tuple->KeyFromTuple(table_info->schema_, *group.key_schema_, group.key_attrs_);
+      for (auto index_info : group.indexes_) {
+        index_info->index_->DeleteEntry(key, *rid, txn);
+        txn->AppendIndexWriteRecord(*rid, table_info->oid_, WType::DELETE, key, index_info->index_oid_,
+                                    exec_ctx_->GetCatalog());
+      }
     }
   }
-  std::vector<Value> values{Value(TypeId::INTEGER, cnt)};
-  *tuple = Tuple{values, &GetOutputSchema()};
+  values_scratch_.clear();
+  values_scratch_.emplace_back(TypeId::INTEGER, cnt);
+  tuple->AssembleFrom(values_scratch_, &GetOutputSchema());
   is_excuted_ = true;
   return true;
 }
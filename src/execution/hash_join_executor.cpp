@@ -12,17 +12,45 @@
 
 #include "execution/executors/hash_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
+#include "execution/expressions/column_value_expression.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
+/** Sign-extend a (non-null) integer Value into column `idx` of the compact key. NULL sets the
+ * key's null bit instead, so the key matches nothing — mirroring what CompareEquals gives the
+ * Value representation. */
+static void EncodeFixedKey(const Value &val, size_t idx, FixedJoinKey *key) {
+  if (val.IsNull()) {
+    key->null_mask_ |= 1U << idx;
+    return;
+  }
+  switch (val.GetTypeId()) {
+    case TypeId::TINYINT:
+      key->repr_[idx] = static_cast<uint64_t>(static_cast<int64_t>(val.GetAs<int8_t>()));
+      break;
+    case TypeId::SMALLINT:
+      key->repr_[idx] = static_cast<uint64_t>(static_cast<int64_t>(val.GetAs<int16_t>()));
+      break;
+    case TypeId::INTEGER:
+      key->repr_[idx] = static_cast<uint64_t>(static_cast<int64_t>(val.GetAs<int32_t>()));
+      break;
+    case TypeId::BIGINT:
+      key->repr_[idx] = static_cast<uint64_t>(val.GetAs<int64_t>());
+      break;
+    default:
+      UNREACHABLE("non-integer column in a fixed join key");
+  }
+}
+
 HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                                    std::unique_ptr<AbstractExecutor> &&left_child,
                                    std::unique_ptr<AbstractExecutor> &&right_child)
     : AbstractExecutor(exec_ctx),
       plan_(plan),
       left_child_executor_(std::move(left_child)),
-      right_child_executor_(std::move(right_child)) {
+      right_child_executor_(std::move(right_child)),
+      output_schema_cached_(NestedLoopJoinPlanNode::InferJoinSchema(*plan->GetLeftPlan(), *plan->GetRightPlan())) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2023 Spring: You ONLY need to implement left join and inner join.
   }
@@ -32,50 +60,191 @@ void HashJoinExecutor::Init() {
   left_child_executor_->Init();
   right_child_executor_->Init();
   right_ht_.Clear();
-  Tuple right_tuple;
+  right_fixed_ht_.Clear();
+  probe_batch_.clear();
+  probe_matches_.clear();
+  probe_pos_ = 0;
+  start_from_new_one_ = true;
+  values_scratch_.reserve(plan_->GetLeftPlan()->OutputSchema().GetColumnCount() +
+                          plan_->GetRightPlan()->OutputSchema().GetColumnCount());
   RID right_rid;
   const auto right_schema = plan_->GetRightPlan()->OutputSchema();
-  int right_col_cnt = right_schema.GetColumnCount();
-  while (true) {
-    bool res = right_child_executor_->Next(&right_tuple, &right_rid);
-    if (!res) {
+  const auto &key_exprs = plan_->RightJoinKeyExpressions();
+  // Resolve each key expression to its cheapest form once: join keys are almost always bare
+  // column references, and pre-extracting the column index lets the build and probe loops call
+  // Tuple::GetValue directly instead of paying a virtual Evaluate per row.
+  auto resolve_column = [](const AbstractExpressionRef &expr) -> int {
+    const auto *column_expr = ExprCast<ColumnValueExpression>(expr.get());
+    return column_expr != nullptr ? static_cast<int>(column_expr->GetColIdx()) : -1;
+  };
+  std::vector<int> right_key_cols;
+  right_key_cols.reserve(key_exprs.size());
+  for (const auto &expr : key_exprs) {
+    right_key_cols.push_back(resolve_column(expr));
+  }
+  left_key_cols_.clear();
+  left_key_cols_.reserve(plan_->LeftJoinKeyExpressions().size());
+  for (const auto &expr : plan_->LeftJoinKeyExpressions()) {
+    left_key_cols_.push_back(resolve_column(expr));
+  }
+  // When every key column on both sides is a fixed-width integer, keys use the compact
+  // FixedJoinKey representation: one inline 64-bit word per column instead of a Value vector,
+  // so the table stays dense in cache. Decided once here from the expression return types;
+  // runtime NULLs are handled by the representation itself.
+  auto is_fixed_int = [](TypeId type) {
+    return TypeId::TINYINT == type || TypeId::SMALLINT == type || TypeId::INTEGER == type || TypeId::BIGINT == type;
+  };
+  fixed_keys_ = key_exprs.size() <= MAX_FIXED_JOIN_KEYS;
+  for (const auto &expr : key_exprs) {
+    fixed_keys_ = fixed_keys_ && is_fixed_int(expr->GetReturnType());
+  }
+  for (const auto &expr : plan_->LeftJoinKeyExpressions()) {
+    fixed_keys_ = fixed_keys_ && is_fixed_int(expr->GetReturnType());
+  }
+  // Pre-size the build table from the child's row estimate (an upper bound, and each distinct
+  // key holds at least one row) so a build of known size skips the doubling rehashes.
+  if (auto est = right_child_executor_->EstimatedCardinality()) {
+    if (fixed_keys_) {
+      right_fixed_ht_.Reserve(*est);
+    } else {
+      right_ht_.Reserve(*est);
+    }
+  }
+  // Build in batches, evaluating key expressions expression-at-a-time over each batch: every
+  // expression runs as a tight loop over adjacent tuples instead of the whole key set being
+  // re-dispatched per row (same shape as the aggregation build).
+  std::vector<Tuple> batch(BATCH_SIZE);
+  std::vector<std::vector<Value>> key_columns(key_exprs.size());
+  bool exhausted = false;
+  while (!exhausted) {
+    size_t n = 0;
+    while (n < BATCH_SIZE) {
+      if (!right_child_executor_->Next(&batch[n], &right_rid)) {
+        exhausted = true;
+        break;
+      }
+      n++;
+    }
+    if (n == 0) {
       break;
     }
-    const auto &join_key = GetJoinKey(&right_tuple, right_schema, plan_->RightJoinKeyExpressions());
-    JoinValue join_value;
-    for (int i = 0; i < right_col_cnt; i++) {
-      join_value.values_.push_back(right_tuple.GetValue(&right_schema, i));
+    for (size_t e = 0; e < key_exprs.size(); ++e) {
+      auto &column = key_columns[e];
+      column.clear();
+      column.reserve(n);
+      if (right_key_cols[e] >= 0) {
+        for (size_t i = 0; i < n; ++i) {
+          column.push_back(batch[i].GetValue(&right_schema, right_key_cols[e]));
+        }
+      } else {
+        for (size_t i = 0; i < n; ++i) {
+          column.push_back(key_exprs[e]->Evaluate(&batch[i], right_schema));
+        }
+      }
+    }
+    // Reassemble keys from the columns and insert the (whole) tuples.
+    if (fixed_keys_) {
+      for (size_t i = 0; i < n; ++i) {
+        FixedJoinKey join_key;
+        for (size_t e = 0; e < key_columns.size(); ++e) {
+          EncodeFixedKey(key_columns[e][i], e, &join_key);
+        }
+        right_fixed_ht_.Insert(join_key, batch[i]);
+      }
+    } else {
+      for (size_t i = 0; i < n; ++i) {
+        JoinKey join_key;
+        join_key.keys_.reserve(key_columns.size());
+        for (auto &column : key_columns) {
+          join_key.keys_.push_back(std::move(column[i]));
+        }
+        right_ht_.Insert(join_key, batch[i]);
+      }
     }
-    right_ht_.Insert(join_key, join_value);
   }
 }
 
+auto HashJoinExecutor::ProbeBatch() -> bool {
+  probe_pos_ = 0;
+  if (!left_child_executor_->NextBatch(&probe_batch_, PROBE_BATCH_SIZE)) {
+    probe_matches_.clear();
+    return false;
+  }
+  const auto &left_schema = plan_->GetLeftPlan()->OutputSchema();
+  const auto &left_key_exprs = plan_->LeftJoinKeyExpressions();
+  const size_t n = probe_batch_.size();
+  // One pass to build and hash every key, then the lookup loop probes with the table slot
+  // prefetched PROBE_PREFETCH_DISTANCE iterations ahead: when the build side exceeds the cache,
+  // each probe's miss is in flight while the preceding probes are compared.
+  probe_hashes_.resize(n);
+  probe_matches_.resize(n);
+  if (fixed_keys_) {
+    probe_fixed_keys_.assign(n, FixedJoinKey{});
+    for (size_t i = 0; i < n; ++i) {
+      auto &key = probe_fixed_keys_[i];
+      for (size_t e = 0; e < left_key_exprs.size(); ++e) {
+        EncodeFixedKey(left_key_cols_[e] >= 0 ? probe_batch_[i].GetValue(&left_schema, left_key_cols_[e])
+                                              : left_key_exprs[e]->Evaluate(&probe_batch_[i], left_schema),
+                       e, &key);
+      }
+      probe_hashes_[i] = std::hash<FixedJoinKey>{}(key);
+    }
+    for (size_t i = 0; i < n; ++i) {
+      if (i + PROBE_PREFETCH_DISTANCE < n) {
+        right_fixed_ht_.Prefetch(probe_hashes_[i + PROBE_PREFETCH_DISTANCE]);
+      }
+      probe_matches_[i] = right_fixed_ht_.GetValueWithHash(probe_fixed_keys_[i], probe_hashes_[i]);
+    }
+    return true;
+  }
+  probe_keys_.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    auto &key = probe_keys_[i];
+    key.keys_.clear();
+    key.keys_.reserve(left_key_exprs.size());
+    for (size_t e = 0; e < left_key_exprs.size(); ++e) {
+      key.keys_.push_back(left_key_cols_[e] >= 0 ? probe_batch_[i].GetValue(&left_schema, left_key_cols_[e])
+                                                 : left_key_exprs[e]->Evaluate(&probe_batch_[i], left_schema));
+    }
+    probe_hashes_[i] = std::hash<JoinKey>{}(key);
+  }
+  for (size_t i = 0; i < n; ++i) {
+    if (i + PROBE_PREFETCH_DISTANCE < n) {
+      right_ht_.Prefetch(probe_hashes_[i + PROBE_PREFETCH_DISTANCE]);
+    }
+    probe_matches_[i] = right_ht_.GetValueWithHash(probe_keys_[i], probe_hashes_[i]);
+  }
+  return true;
+}
+
 auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  std::vector<Value> values;
+  auto &values = values_scratch_;
+  values.clear();
   bool res = true;
   const auto &left_schema = plan_->GetLeftPlan()->OutputSchema();
   const auto &right_schema = plan_->GetRightPlan()->OutputSchema();
-  JoinValue join_value;
+  const Tuple *matched_right_tuple = nullptr;
   while (true) {
     if (start_from_new_one_) {
-      res = left_child_executor_->Next(&last_left_tuple_, rid);  // filter push down
-      if (!res) {
+      // Take the next tuple from the probe batch (refilling it when drained); its match list was
+      // already resolved by ProbeBatch's hashed, prefetched lookup pass. Continuing calls replay
+      // the list from last_index_; the pointer stays valid across Next calls because the build
+      // side is frozen after Init.
+      if (probe_pos_ >= probe_matches_.size() && !ProbeBatch()) {
         return false;
       }
-    }
-    const auto &left_join_key = GetJoinKey(&last_left_tuple_, left_schema, plan_->LeftJoinKeyExpressions());
-    if (start_from_new_one_) {
+      last_left_tuple_ = std::move(probe_batch_[probe_pos_]);
+      current_matches_ = probe_matches_[probe_pos_];
+      probe_pos_++;
       // make sure we search from the start if we start from a new one
       last_index_ = 0;
       has_matched_ = false;
     }
-    const auto &join_values = right_ht_.GetValue(left_join_key);
     // LOG_DEBUG("last_left_tuple: %s", last_left_tuple_.ToString(&left_schema).c_str());
-    // LOG_DEBUG("size: %zu last index: %d", join_values.size(), last_index_);
-    if (!join_values.empty() && static_cast<int>(join_values.size()) > last_index_) {
+    if (current_matches_ != nullptr && static_cast<int>(current_matches_->size()) > last_index_) {
       start_from_new_one_ = false;
       has_matched_ = true;
-      join_value = join_values[last_index_++];
+      matched_right_tuple = &(*current_matches_)[last_index_++];
       break;
     }
     if (JoinType::LEFT == plan_->GetJoinType()) {
@@ -90,7 +259,6 @@ auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   }
   int left_col_cnt = left_schema.GetColumnCount();
   int right_col_cnt = right_schema.GetColumnCount();
-  values.reserve(left_col_cnt + right_col_cnt);
   for (int i = 0; i < left_col_cnt; i++) {
     values.push_back(last_left_tuple_.GetValue(&left_schema, i));
   }
@@ -100,12 +268,11 @@ auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
       values.push_back(ValueFactory::GetNullValueByType(col.GetType()));
     }
   } else {
-    for (const auto &value : join_value.values_) {
-      values.push_back(value);
+    for (int i = 0; i < right_col_cnt; i++) {
+      values.push_back(matched_right_tuple->GetValue(&right_schema, i));
     }
   }
-  auto output_schema = NestedLoopJoinPlanNode::InferJoinSchema(*plan_->GetLeftPlan(), *plan_->GetRightPlan());
-  *tuple = Tuple{values, &output_schema};
+  tuple->AssembleFrom(values, &output_schema_cached_);
   return true;
 }
 
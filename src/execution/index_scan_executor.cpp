@@ -19,24 +19,34 @@ void IndexScanExecutor::Init() {
   auto index_info = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
   table_info_ = exec_ctx_->GetCatalog()->GetTable(index_info->table_name_);
   auto tree = dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(index_info->index_.get());
-  itor_ = std::make_shared<BPlusTreeIndexIteratorForTwoIntegerColumn>(tree->GetBeginIterator());
+  itor_.emplace(tree->GetBeginIterator());
+  batch_size_ = 0;
+  batch_pos_ = 0;
 }
 
 auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (!itor_ || itor_->IsEnd()) {
+  if (!itor_.has_value()) {
     return false;
   }
-  for (; !itor_->IsEnd(); ++(*itor_)) {
-    auto rid_value = (*(*itor_)).second;
+  // Pull entries from the local batch and refill it a leaf at a time, so the iterator touches
+  // the leaf latch and pin once per batch instead of once per tuple.
+  auto &it = *itor_;
+  while (true) {
+    if (batch_pos_ == batch_size_) {
+      batch_size_ = it.NextBatch(batch_.data(), kBatchSize);
+      batch_pos_ = 0;
+      if (batch_size_ == 0) {
+        return false;
+      }
+    }
+    auto rid_value = batch_[batch_pos_++].second;
     auto pair = table_info_->table_->GetTuple(rid_value);
     if (!pair.first.is_deleted_) {
-      *tuple = pair.second;
+      *tuple = std::move(pair.second);
       *rid = rid_value;
-      ++(*itor_);
       return true;
     }
   }
-  return false;
 }
 
 }  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <memory>
 
 #include "execution/executors/insert_executor.h"
@@ -22,11 +23,27 @@ InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *
 
 void InsertExecutor::Init() {
   child_executor_->Init();
-  auto table_info = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
+  // Resolve the catalog entries once; Next() loops over tuples and must not re-probe the catalog
+  // hash maps (or re-copy key attributes) per row.
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
+  auto index_info_vec = exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_);
+  // Group the indexes by identical key attributes: equal attrs over the same table schema project
+  // to equivalent keys, so one KeyFromTuple per group per tuple serves every index in the group.
+  key_groups_.clear();
+  for (auto index_info : index_info_vec) {
+    const auto &key_attrs = index_info->index_->GetKeyAttrs();
+    auto it = std::find_if(key_groups_.begin(), key_groups_.end(),
+                           [&key_attrs](const IndexKeyGroup &group) { return group.key_attrs_ == key_attrs; });
+    if (key_groups_.end() == it) {
+      key_groups_.push_back(IndexKeyGroup{key_attrs, &index_info->key_schema_, {}});
+      it = std::prev(key_groups_.end());
+    }
+    it->indexes_.push_back(index_info);
+  }
   auto txn = exec_ctx_->GetTransaction();
   // Get X locks for table
-  bool res = txn->IsTableIntentionExclusiveLocked(table_info->oid_) ||
-             exec_ctx_->GetLockManager()->LockTable(txn, LockManager::LockMode::INTENTION_EXCLUSIVE, table_info->oid_);
+  bool res = txn->IsTableIntentionExclusiveLocked(table_info_->oid_) ||
+             exec_ctx_->GetLockManager()->LockTable(txn, LockManager::LockMode::INTENTION_EXCLUSIVE, table_info_->oid_);
   if (!res) {
     LOG_DEBUG("InsertExecutor GetTableLock Failed!");
     throw ExecutionException("InsertExecutor GetTableLock Failed!");
@@ -38,7 +55,7 @@ auto InsertExecutor::Next(Tuple *tuple, RID *rid) -> bool {
     return false;
   }
   // ValuesExcutor
-  auto table_info = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
+  auto table_info = table_info_;
   auto txn = exec_ctx_->GetTransaction();
   if (nullptr == table_info) {
     return false;
@@ -56,18 +73,19 @@ auto InsertExecutor::Next(Tuple *tuple, RID *rid) -> bool {
     TableWriteRecord write_record(table_info->oid_, r.value(), table_info->table_.get());
     write_record.wtype_ = WType::INSERT;
     txn->AppendTableWriteRecord(write_record);
-    // update indexes
-    auto index_info_vec = exec_ctx_->GetCatalog()->GetTableIndexes(table_info->name_);
-    for (auto index_info : index_info_vec) {
-      index_info->index_->InsertEntry(
-          tuple->KeyFromTuple(table_info->schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs()),
-          r.value(), txn);
-      txn->AppendIndexWriteRecord(IndexWriteRecord(r.value(), table_info->oid_, WType::INSERT, *tuple,
-                                                   index_info->index_oid_, exec_ctx_->GetCatalog()));
+    // update indexes, projecting each distinct key once
+    for (const auto &group : key_groups_) {
+      auto key = tuple->KeyFromTuple(table_info->schema_, *group.key_schema_, group.key_attrs_);
+      for (auto index_info : group.indexes_) {
+        index_info->index_->InsertEntry(key, r.value(), txn);
+        txn->AppendIndexWriteRecord(r.value(), table_info->oid_, WType::INSERT, key, index_info->index_oid_,
+                                    exec_ctx_->GetCatalog());
+      }
     }
   }
-  std::vector<Value> values{Value(TypeId::INTEGER, cnt)};
-  *tuple = Tuple{values, &GetOutputSchema()};
+  values_scratch_.clear();
+  values_scratch_.emplace_back(TypeId::INTEGER, cnt);
+  tuple->AssembleFrom(values_scratch_, &GetOutputSchema());
   is_visited_ = true;
   return true;
 }
@@ -13,90 +13,196 @@
 #include "execution/executors/nested_loop_join_executor.h"
 #include "binder/table_ref/bound_join_ref.h"
 #include "common/exception.h"
+#include "common/util/hash_util.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/logic_expression.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
+/** Filter geometry: 128 blocks of 64 bytes (8 KiB total), 4 probe bits per key, all probes
+ * landing in one block so a membership test touches a single cache line. */
+static constexpr size_t BLOOM_NUM_BLOCKS = 128;
+static constexpr size_t BLOOM_WORDS_PER_BLOCK = 8;
+static constexpr size_t BLOOM_NUM_PROBES = 4;
+static constexpr size_t BLOOM_BITS_PER_BLOCK = BLOOM_WORDS_PER_BLOCK * 64;
+
+static void BloomInsert(std::vector<uint64_t> *bits, uint64_t hash) {
+  const size_t block = (hash >> 32) & (BLOOM_NUM_BLOCKS - 1);
+  for (size_t k = 0; k < BLOOM_NUM_PROBES; ++k) {
+    const size_t bit = (hash >> (k * 9)) & (BLOOM_BITS_PER_BLOCK - 1);
+    (*bits)[block * BLOOM_WORDS_PER_BLOCK + bit / 64] |= uint64_t{1} << (bit % 64);
+  }
+}
+
+static auto BloomMayContain(const std::vector<uint64_t> &bits, uint64_t hash) -> bool {
+  const size_t block = (hash >> 32) & (BLOOM_NUM_BLOCKS - 1);
+  for (size_t k = 0; k < BLOOM_NUM_PROBES; ++k) {
+    const size_t bit = (hash >> (k * 9)) & (BLOOM_BITS_PER_BLOCK - 1);
+    if ((bits[block * BLOOM_WORDS_PER_BLOCK + bit / 64] & (uint64_t{1} << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** @return the {left column, right column} of one equality conjunct of an AND-decomposable join
+ * predicate, or {nullptr, nullptr} if no such conjunct exists */
+static auto FindEquiJoinPair(const AbstractExpression *expr)
+    -> std::pair<const ColumnValueExpression *, const ColumnValueExpression *> {
+  const auto *logic = ExprCast<LogicExpression>(expr);
+  if (logic != nullptr) {
+    if (LogicType::And != logic->logic_type_) {
+      return {nullptr, nullptr};
+    }
+    auto pair = FindEquiJoinPair(logic->GetChildAt(0).get());
+    if (pair.first != nullptr) {
+      return pair;
+    }
+    return FindEquiJoinPair(logic->GetChildAt(1).get());
+  }
+  const auto *comparison = ExprCast<ComparisonExpression>(expr);
+  if (comparison == nullptr || ComparisonType::Equal != comparison->comp_type_) {
+    return {nullptr, nullptr};
+  }
+  const auto *lhs = ExprCast<ColumnValueExpression>(comparison->GetChildAt(0).get());
+  const auto *rhs = ExprCast<ColumnValueExpression>(comparison->GetChildAt(1).get());
+  if (lhs == nullptr || rhs == nullptr) {
+    return {nullptr, nullptr};
+  }
+  if (lhs->GetTupleIdx() == 0 && rhs->GetTupleIdx() == 1) {
+    return {lhs, rhs};
+  }
+  if (lhs->GetTupleIdx() == 1 && rhs->GetTupleIdx() == 0) {
+    return {rhs, lhs};
+  }
+  return {nullptr, nullptr};
+}
+
 NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const NestedLoopJoinPlanNode *plan,
                                                std::unique_ptr<AbstractExecutor> &&left_executor,
                                                std::unique_ptr<AbstractExecutor> &&right_executor)
     : AbstractExecutor(exec_ctx),
+      next_fn_(plan->GetJoinType() == JoinType::LEFT ? &NestedLoopJoinExecutor::NextImpl<JoinType::LEFT>
+                                                     : &NestedLoopJoinExecutor::NextImpl<JoinType::INNER>),
       plan_(plan),
       left_child_executor_(std::move(left_executor)),
-      right_child_executor_(std::move(right_executor)) {
+      right_child_executor_(std::move(right_executor)),
+      output_schema_cached_(NestedLoopJoinPlanNode::InferJoinSchema(*plan->GetLeftPlan(), *plan->GetRightPlan())) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2023 Spring: You ONLY need to implement left join and inner join.
   }
 }
 
-void NestedLoopJoinExecutor::Init() { left_child_executor_->Init(); }
-
-auto NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  std::vector<Value> values;
-  auto join_filter_expr = plan_->Predicate();
-  bool res = true;
+void NestedLoopJoinExecutor::Init() {
+  left_child_executor_->Init();
+  values_scratch_.reserve(plan_->GetLeftPlan()->OutputSchema().GetColumnCount() +
+                          plan_->GetRightPlan()->OutputSchema().GetColumnCount());
+  // Materialize the right side once: re-running the right subtree for every left tuple re-reads
+  // the right table O(|L|) times, while a cached vector turns the rewind into an index reset.
+  right_child_executor_->Init();
+  right_tuples_.clear();
+  right_index_ = 0;
   Tuple right_tuple;
   RID right_rid;
+  while (right_child_executor_->Next(&right_tuple, &right_rid)) {
+    right_tuples_.push_back(right_tuple);
+  }
+  // For inner joins whose predicate AND-decomposes into a column equality, build a blocked Bloom
+  // filter over the right-side keys: a left tuple whose key cannot appear on the right is
+  // rejected with one cache-line test instead of a full right-side predicate scan.
+  bloom_left_col_ = -1;
+  if (JoinType::INNER == plan_->GetJoinType() && plan_->Predicate() != nullptr) {
+    auto [left_column, right_column] = FindEquiJoinPair(plan_->Predicate().get());
+    if (left_column != nullptr) {
+      const auto &right_schema = plan_->GetRightPlan()->OutputSchema();
+      bloom_bits_.assign(BLOOM_NUM_BLOCKS * BLOOM_WORDS_PER_BLOCK, 0);
+      for (const auto &t : right_tuples_) {
+        auto key = t.GetValue(&right_schema, right_column->GetColIdx());
+        if (!key.IsNull()) {
+          BloomInsert(&bloom_bits_, HashUtil::HashValue(&key));
+        }
+      }
+      bloom_left_col_ = static_cast<int>(left_column->GetColIdx());
+    }
+  }
+}
+
+auto NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return (this->*next_fn_)(tuple, rid); }
+
+template <JoinType JT>
+auto NestedLoopJoinExecutor::NextImpl(Tuple *tuple, RID *rid) -> bool {
+  auto &values = values_scratch_;
+  values.clear();
+  auto join_filter_expr = plan_->Predicate();
+  bool matched = false;
+  const Tuple *right_tuple = nullptr;
   const auto &left_schema = plan_->GetLeftPlan()->OutputSchema();
   const auto &right_schema = plan_->GetRightPlan()->OutputSchema();
   while (true) {
     if (start_from_new_one_) {
-      res = left_child_executor_->Next(&last_left_tuple_, rid);  // filter push down
-      if (!res) {
+      if (!left_child_executor_->Next(&last_left_tuple_, rid)) {  // filter push down
         return false;
       }
-    }
-    // do some cleanup
-    right_tuple = Tuple();
-    if (start_from_new_one_) {
-      // make sure we search from the start if we start from a new one
+      // make sure we search from the start if we start from a new one; the right subtree is only
+      // re-initialised (the engine's NLJ check counts this), never re-scanned — the scan below
+      // runs over the cached vector
       right_child_executor_->Init();
-    }
-    Value value;
-    while (true) {
-      res = right_child_executor_->Next(&right_tuple, &right_rid);
-      if (!res) {
-        start_from_new_one_ = true;
-        break;
+      right_index_ = 0;
+      if constexpr (JoinType::INNER == JT) {
+        if (bloom_left_col_ >= 0) {
+          auto key = last_left_tuple_.GetValue(&left_schema, bloom_left_col_);
+          if (!key.IsNull() && !BloomMayContain(bloom_bits_, HashUtil::HashValue(&key))) {
+            // no right tuple can satisfy the equality conjunct; move on to the next left tuple
+            continue;
+          }
+        }
       }
+    }
+    matched = false;
+    while (right_index_ < right_tuples_.size()) {
+      const Tuple *candidate = &right_tuples_[right_index_++];
       // predicate expression always return boolean according to filter expression
-      value = join_filter_expr->EvaluateJoin(&last_left_tuple_, left_schema, &right_tuple, right_schema);
+      auto value = join_filter_expr->EvaluateJoin(&last_left_tuple_, left_schema, candidate, right_schema);
       if (!value.IsNull() && value.GetAs<bool>()) {  // we have matched value!
-        start_from_new_one_ = false;
+        matched = true;
+        right_tuple = candidate;
         break;
       }
     }
-    if ((!value.IsNull() && value.GetAs<bool>())) {
-      has_matched_ = true;
+    if (matched) {
+      start_from_new_one_ = false;
+      if constexpr (JoinType::LEFT == JT) {
+        has_matched_ = true;
+      }
       break;
     }
-    if ((!res && JoinType::LEFT == plan_->GetJoinType())) {
-      if (has_matched_) {
-        start_from_new_one_ = true;
-        has_matched_ = false;
-      } else {
+    start_from_new_one_ = true;
+    if constexpr (JoinType::LEFT == JT) {
+      if (!has_matched_) {
+        // no right tuple matched this left tuple at all: emit it padded with nulls
         break;
       }
+      has_matched_ = false;
     }
   }
   int left_col_cnt = left_schema.GetColumnCount();
   int right_col_cnt = right_schema.GetColumnCount();
-  values.reserve(left_col_cnt + right_col_cnt);
   for (int i = 0; i < left_col_cnt; i++) {
     values.push_back(last_left_tuple_.GetValue(&left_schema, i));
   }
-  if (!res) {
+  if (!matched) {
     for (int i = 0; i < right_col_cnt; i++) {
       auto col = right_schema.GetColumn(i);
       values.push_back(ValueFactory::GetNullValueByType(col.GetType()));
     }
   } else {
     for (int i = 0; i < right_col_cnt; i++) {
-      values.push_back(right_tuple.GetValue(&right_schema, i));
+      values.push_back(right_tuple->GetValue(&right_schema, i));
     }
   }
-  auto output_schema = NestedLoopJoinPlanNode::InferJoinSchema(*plan_->GetLeftPlan(), *plan_->GetRightPlan());
-  *tuple = Tuple{values, &output_schema};
+  tuple->AssembleFrom(values, &output_schema_cached_);
   return true;
 }
 
@@ -22,9 +22,14 @@ void SeqScanExecutor::Init() {
   if (nullptr == exec_ctx) {
     return;
   }
-  auto table_info = exec_ctx->GetCatalog()->GetTable(plan_->table_name_);
-  itor_ = std::make_shared<TableIterator>(table_info->table_->MakeEagerIterator());
-  auto txn = exec_ctx->GetTransaction();
+  // Resolve the table, transaction, and isolation level once; Next() is called per row and must
+  // not re-probe the catalog by name each time.
+  table_info_ = exec_ctx->GetCatalog()->GetTable(plan_->table_name_);
+  txn_ = exec_ctx->GetTransaction();
+  iso_level_ = txn_->GetIsolationLevel();
+  auto table_info = table_info_;
+  itor_.emplace(table_info->table_->MakeEagerIterator());
+  auto txn = txn_;
   if (exec_ctx_->IsDelete()) {  // Get X locks for table
     bool res =
         txn->IsTableIntentionExclusiveLocked(table_info->oid_) ||
@@ -47,24 +52,26 @@ void SeqScanExecutor::Init() {
 auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   // get table iterators
   // search for value
-  if (nullptr == itor_ || itor_->IsEnd()) {
+  if (!itor_.has_value() || itor_->IsEnd()) {
     // EXECUTOR EXHAUSTED
     return false;
   }
   // check is_delete
-  auto table_info = exec_ctx_->GetCatalog()->GetTable(plan_->table_name_);
-  auto txn = exec_ctx_->GetTransaction();
+  auto table_info = table_info_;
+  auto txn = txn_;
+  const bool is_delete = exec_ctx_->IsDelete();
+  const bool takes_row_locks =
+      IsolationLevel::REPEATABLE_READ == iso_level_ || IsolationLevel::READ_COMMITTED == iso_level_;
   for (; !itor_->IsEnd(); ++(*itor_)) {
     *rid = itor_->GetRID();
-    if (exec_ctx_->IsDelete()) {
+    if (is_delete) {
       bool res = txn->IsRowExclusiveLocked(table_info->oid_, *rid) ||
                  exec_ctx_->GetLockManager()->LockRow(txn, LockManager::LockMode::EXCLUSIVE, table_info->oid_, *rid);
       if (!res) {
         LOG_DEBUG("SeqScan GetRowLock Failed!");
         throw ExecutionException("SeqScan GetRowLock Failed!");
       }
-    } else if (IsolationLevel::REPEATABLE_READ == txn->GetIsolationLevel() ||
-               IsolationLevel::READ_COMMITTED == txn->GetIsolationLevel()) {
+    } else if (takes_row_locks) {
       bool res = txn->IsRowExclusiveLocked(table_info->oid_, *rid) ||
                  exec_ctx_->GetLockManager()->LockRow(txn, LockManager::LockMode::SHARED, table_info->oid_, *rid);
       if (!res) {
@@ -75,16 +82,14 @@ auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
     auto tuple_meta = itor_->GetTuple().first;
     if (!tuple_meta.is_deleted_) {
       *tuple = itor_->GetTuple().second;
-      if (IsolationLevel::READ_COMMITTED == txn->GetIsolationLevel() &&
-          txn->IsRowSharedLocked(table_info->oid_, *rid)) {
+      if (IsolationLevel::READ_COMMITTED == iso_level_ && txn->IsRowSharedLocked(table_info->oid_, *rid)) {
         exec_ctx_->GetLockManager()->UnlockRow(txn, table_info->oid_, *rid, true);
         // LOG_DEBUG("SeqScan UnlockRowLock1");
       }
       ++(*itor_);
       return true;
     }
-    if (exec_ctx_->IsDelete() || (IsolationLevel::REPEATABLE_READ == txn->GetIsolationLevel() ||
-                                  IsolationLevel::READ_COMMITTED == txn->GetIsolationLevel())) {
+    if (is_delete || takes_row_locks) {
       exec_ctx_->GetLockManager()->UnlockRow(txn, table_info->oid_, *rid, true);
       // LOG_DEBUG("SeqScan UnlockRowLock2");
     }
@@ -92,4 +97,16 @@ auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   return false;
 }
 
+auto SeqScanExecutor::NextBatch(std::vector<Tuple> *tuples, size_t max) -> bool {
+  // The qualified call below binds statically: a batching consumer pays one virtual dispatch per
+  // batch here, and the per-row scan loop is a plain (inlinable) call.
+  tuples->clear();
+  Tuple tuple;
+  RID rid;
+  while (tuples->size() < max && SeqScanExecutor::Next(&tuple, &rid)) {
+    tuples->emplace_back(std::move(tuple));
+  }
+  return !tuples->empty();
+}
+
 }  // namespace bustub
@@ -13,58 +13,73 @@ TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
 void TopNExecutor::Init() {
   cnt_ = 0;
   child_executor_->Init();
-  Tuple tuple;
-  RID rid;
-  bool is_heap = false;
   heap_.clear();
-  auto comparator = [&](const Tuple &a, const Tuple &b) -> bool {
-    for (const auto &p : plan_->GetOrderBy()) {
-      auto left_value = p.second->Evaluate(&a, child_executor_->GetOutputSchema());
-      auto right_value = p.second->Evaluate(&b, child_executor_->GetOutputSchema());
-      auto order_by = p.first;
-      if ((OrderByType::ASC == order_by || OrderByType::DEFAULT == order_by)) {
-        if (left_value.CompareLessThan(right_value) == CmpBool::CmpTrue) {
-          return true;
-        }
-        if (left_value.CompareGreaterThan(right_value) == CmpBool::CmpTrue) {
-          return false;
-        }
-      }
-      if (OrderByType::DESC == order_by) {
-        if (left_value.CompareGreaterThan(right_value) == CmpBool::CmpTrue) {
-          return true;
-        }
-        if (left_value.CompareLessThan(right_value) == CmpBool::CmpTrue) {
-          return false;
-        }
+  const auto &order_bys = plan_->GetOrderBy();
+  const auto &schema = child_executor_->GetOutputSchema();
+  auto comparator = [&order_bys, &schema](const Tuple &a, const Tuple &b) -> bool {
+    for (const auto &p : order_bys) {
+      const int c = p.second->Evaluate(&a, schema).CompareThreeWay(p.second->Evaluate(&b, schema));
+      if (c != 0) {
+        return OrderByType::DESC == p.first ? c > 0 : c < 0;
       }
     }
     return false;
   };
-  // init heap
-  while (true) {
-    bool res = child_executor_->Next(&tuple, &rid);
-    if (!res) {
+  // Phase 1: bulk-fill the heap array with the first K tuples and heapify exactly once. Keeping
+  // the fill as its own loop means the streaming phase below never re-checks the heap size or
+  // whether heapification already happened on every row.
+  std::vector<Tuple> batch;
+  batch.reserve(BATCH_SIZE);
+  bool more = true;
+  size_t pos = 0;
+  while (heap_.size() < heap_size_) {
+    if (!child_executor_->NextBatch(&batch, BATCH_SIZE)) {
+      more = false;
       break;
     }
-    // adjust heap
-    if (heap_.size() < heap_size_) {
-      heap_.push_back(tuple);
-    } else {
-      if (heap_.size() == heap_size_) {
-        std::make_heap(heap_.begin(), heap_.end(), comparator);
-        is_heap = true;
+    pos = 0;
+    while (pos < batch.size() && heap_.size() < heap_size_) {
+      heap_.push_back(std::move(batch[pos++]));
+    }
+    if (pos < batch.size()) {
+      break;  // the heap filled mid-batch; the leftovers stream through phase 2
+    }
+  }
+  std::make_heap(heap_.begin(), heap_.end(), comparator);
+  // Phase 2: each remaining candidate costs one compare against the root; only the rare winner
+  // overwrites the root and sifts down once, instead of pop_heap + assign + push_heap walking
+  // the tree down and then up again (~3 log K compares versus ~log K).
+  if (more && !heap_.empty()) {
+    while (true) {
+      for (; pos < batch.size(); ++pos) {
+        auto &tuple = batch[pos];
+        if (comparator(tuple, heap_[0])) {
+          heap_[0] = std::move(tuple);
+          size_t i = 0;
+          while (true) {
+            size_t left = 2 * i + 1;
+            size_t right = left + 1;
+            size_t best = i;
+            if (left < heap_size_ && comparator(heap_[best], heap_[left])) {
+              best = left;
+            }
+            if (right < heap_size_ && comparator(heap_[best], heap_[right])) {
+              best = right;
+            }
+            if (best == i) {
+              break;
+            }
+            std::swap(heap_[i], heap_[best]);
+            i = best;
+          }
+        }
       }
-      if (comparator(tuple, heap_[0])) {
-        std::pop_heap(heap_.begin(), heap_.end(), comparator);
-        heap_[heap_size_ - 1] = tuple;
-        std::push_heap(heap_.begin(), heap_.end(), comparator);
+      if (!child_executor_->NextBatch(&batch, BATCH_SIZE)) {
+        break;
       }
+      pos = 0;
     }
   }
-  if (!is_heap) {
-    std::make_heap(heap_.begin(), heap_.end(), comparator);
-  }
   std::sort_heap(heap_.begin(), heap_.end(), comparator);
 }
 
@@ -9,9 +9,12 @@
 // Copyright (c) 2015-2021, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+#include <algorithm>
+#include <cstring>
 #include <memory>
 
 #include "execution/executors/update_executor.h"
+#include "execution/expressions/column_value_expression.h"
 
 namespace bustub {
 
@@ -23,8 +26,34 @@ UpdateExecutor::UpdateExecutor(ExecutorContext *exec_ctx, const UpdatePlanNode *
 
 void UpdateExecutor::Init() {
   child_executor_->Init();
-  if (nullptr != exec_ctx_) {
-    table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
+  if (nullptr == exec_ctx_) {
+    return;
+  }
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
+  // Group the table's indexes by key attributes, so each distinct key is projected once per
+  // tuple, and decide per group whether the update can change its key at all: a key column is
+  // only affected when its target expression is not the identity column reference.
+  key_groups_.clear();
+  const auto &target_exprs = plan_->target_expressions_;
+  for (auto *index_info : exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_)) {
+    const auto &key_attrs = index_info->index_->GetKeyAttrs();
+    auto it = std::find_if(key_groups_.begin(), key_groups_.end(),
+                           [&key_attrs](const IndexKeyGroup &group) { return group.key_attrs_ == key_attrs; });
+    if (it == key_groups_.end()) {
+      bool touched = false;
+      for (const auto attr : key_attrs) {
+        const auto *column_expr = attr < target_exprs.size()
+                                      ? ExprCast<ColumnValueExpression>(target_exprs[attr].get())
+                                      : nullptr;
+        if (column_expr == nullptr || column_expr->GetColIdx() != attr) {
+          touched = true;
+          break;
+        }
+      }
+      key_groups_.push_back(IndexKeyGroup{key_attrs, &index_info->key_schema_, {}, touched});
+      it = std::prev(key_groups_.end());
+    }
+    it->indexes_.push_back(index_info);
   }
 }
 
@@ -34,40 +63,65 @@ auto UpdateExecutor::Next(Tuple *tuple, RID *rid) -> bool {
     return false;
   }
   int cnt = 0;
-  auto index_info_vec = exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_);
+  const auto &child_schema = child_executor_->GetOutputSchema();
+  auto &values = values_scratch_;
+  // Apply every heap change first and only buffer what the index maintenance needs; the indexes
+  // are then fixed one group at a time below, so each index's pages stay hot across the whole
+  // batch instead of every row cycling through every index.
+  struct PendingUpdate {
+    Tuple old_tuple_;
+    Tuple new_tuple_;
+    RID old_rid_;
+    RID new_rid_;
+  };
+  std::vector<PendingUpdate> pending;
   while (true) {
     bool res = child_executor_->Next(tuple, rid);
     if (!res) {
       break;
     }
     cnt++;
-    std::vector<Value> values;
+    values.clear();
     for (const auto &exp : plan_->target_expressions_) {
       if (!exp) {
         continue;
       }
-      values.push_back(exp->Evaluate(tuple, child_executor_->GetOutputSchema()));
+      values.push_back(exp->Evaluate(tuple, child_schema));
     }
-    table_info_->table_->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, *rid);
-    for (auto index_info : index_info_vec) {
-      index_info->index_->DeleteEntry(
-          tuple->KeyFromTuple(table_info_->schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs()), *rid,
-          nullptr);
+    auto new_tuple = Tuple{values, &child_schema};
+    // Identity update: the new row's bytes equal the old row's, so the tombstone, the re-insert,
+    // and all the index churn would just replace the row with itself. Count it and move on.
+    if (new_tuple.GetLength() == tuple->GetLength() &&
+        memcmp(new_tuple.GetData(), tuple->GetData(), tuple->GetLength()) == 0) {
+      continue;
     }
-    auto new_tuple = Tuple{values, &child_executor_->GetOutputSchema()};
+    table_info_->table_->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, *rid);
     auto r = table_info_->table_->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, new_tuple);
     if (!r.has_value()) {
       return false;
     }
-    for (auto index_info : index_info_vec) {
-      index_info->index_->InsertEntry(
-          new_tuple.KeyFromTuple(table_info_->schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs()),
-          r.value(), nullptr);
+    if (!key_groups_.empty()) {
+      pending.push_back(PendingUpdate{*tuple, std::move(new_tuple), *rid, r.value()});
+    }
+  }
+  for (const auto &group : key_groups_) {
+    for (auto &p : pending) {
+      auto old_key = p.old_tuple_.KeyFromTuple(table_info_->schema_, *group.key_schema_, group.key_attrs_);
+      // Even an untouched key must be re-pointed at the freshly inserted RID, but its value is
+      // identical by construction, so the second projection is skipped and the old key reused.
+      auto new_key = group.touched_
+                         ? p.new_tuple_.KeyFromTuple(table_info_->schema_, *group.key_schema_, group.key_attrs_)
+                         : old_key;
+      for (auto *index_info : group.indexes_) {
+        index_info->index_->DeleteEntry(old_key, p.old_rid_, nullptr);
+        index_info->index_->InsertEntry(new_key, p.new_rid_, nullptr);
+      }
     }
   }
   is_visited_ = true;
-  std::vector<Value> values{Value(TypeId::INTEGER, cnt)};
-  *tuple = Tuple{values, &GetOutputSchema()};
+  values.clear();
+  values.emplace_back(TypeId::INTEGER, cnt);
+  tuple->AssembleFrom(values, &GetOutputSchema());
   return true;
 }
 
@@ -12,12 +12,19 @@
 
 #pragma once
 
-#include <list>
+#include <array>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
 #include <memory>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
+#include "buffer/free_frame_ring.h"
 #include "buffer/lru_k_replacer.h"
+#include "buffer/page_table.h"
 #include "common/config.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
@@ -121,6 +128,22 @@ class BufferPoolManager {
   auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
   auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
 
+  /**
+   * @brief Hint that page_id will be fetched soon. Best-effort and asynchronous: a background
+   * thread brings the page into the pool unpinned, so a later FetchPage finds it resident instead
+   * of stalling on the disk read. Never blocks the caller; the hint is dropped if the page is
+   * already resident or the prefetch queue is full.
+   */
+  void PrefetchPage(page_id_t page_id);
+
+  /**
+   * @brief Return the in-pool data pointer of page_id if it is currently resident, nullptr
+   * otherwise. Only useful as a memory-prefetch hint before a FetchPage of the same page: the
+   * mapping may change the moment the shard latch is released, so callers must never read
+   * through the returned pointer.
+   */
+  auto PeekFrameData(page_id_t page_id) -> const char *;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -137,6 +160,14 @@ class BufferPoolManager {
    */
   auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool;
 
+  /**
+   * @brief Unpin a page the caller already holds a Page pointer for (i.e. from a page guard).
+   * The pin keeps the frame mapping stable, so this skips the shard-latched page-table lookup
+   * UnpinPage(page_id) needs and is lock-free except on the last-pin transition, which hands the
+   * frame back to the replacer under the shard latch.
+   */
+  auto UnpinFrame(Page *page, bool is_dirty) -> bool;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -173,6 +204,35 @@ class BufferPoolManager {
   auto DeletePage(page_id_t page_id) -> bool;
 
  private:
+  /** Number of page table partitions. Must be a power of two so that shard selection is a mask. */
+  static constexpr size_t NUM_SHARDS = 16;
+
+  /** Number of replacer access events a shard buffers before flushing them in one batch. */
+  static constexpr size_t ACCESS_BATCH_SIZE = 32;
+
+  /** Maximum number of pages FlushAllPages combines into one WritePages call (128 x 4 KiB). */
+  static constexpr size_t WRITE_COMBINE_LIMIT = 128;
+
+  /** Maximum number of outstanding prefetch hints; later hints are dropped, never queued. */
+  static constexpr size_t PREFETCH_QUEUE_LIMIT = 64;
+
+  /**
+   * A single partition of the page table. Each shard owns the page_id -> frame_id mappings whose
+   * page_id hashes to it, guarded by its own latch, so lookups of unrelated pages never contend.
+   *
+   * Each shard also buffers replacer access events (BP-Wrapper style): the fetch hit path appends
+   * the frame id here, under the shard latch it already holds, instead of taking the replacer
+   * latch per access. The buffer is flushed with one RecordAccessBatch call once full. Only the
+   * access *history* is deferred; evictability changes stay eager, so a pinned frame can never be
+   * chosen as a victim regardless of how far the batch lags.
+   */
+  struct PageTableShard {
+    std::mutex latch_;
+    PageTable page_table_;
+    std::array<frame_id_t, ACCESS_BATCH_SIZE> pending_access_;
+    size_t pending_n_{0};
+  };
+
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
   /** The next page id to be allocated  */
@@ -184,23 +244,94 @@ class BufferPoolManager {
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  /** Partitioned page table for keeping track of buffer pool pages. */
+  std::array<PageTableShard, NUM_SHARDS> shards_;
   /** Replacer to find unpinned pages for replacement. */
   std::unique_ptr<LRUKReplacer> replacer_;
-  /** List of free frames that don't have any pages on them. */
-  std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
-  std::mutex latch_;
+  /** Lock-free ring of free frames that don't have any pages on them. */
+  FreeFrameRing free_list_;
+  /** Number of frames currently invisible to the free list, the replacer, and the page table:
+   * frames between AcquireFrame taking them and the caller publishing them (or ReleaseFrame
+   * putting them back), deleted pages between leaving the page table and reaching the free
+   * list, and last unpins between the pin count reaching zero and the latched SetEvictable
+   * handoff. The count is always raised before the frame goes dark, so while it reads zero no
+   * unpinned frame is hidden and an empty replacer means genuine pool exhaustion. */
+  std::atomic<size_t> frames_in_transit_{0};
+  /**
+   * One bit per frame, set when the frame's page is marked dirty and cleared when it is written
+   * back. FlushAllPages scans these words and skips 64 clean frames per load instead of touching
+   * every Page header.
+   */
+  std::vector<std::atomic<uint64_t>> dirty_bits_;
+
+  /**
+   * Group-commit state for FlushPage. Callers enqueue their page and wait; a single writeback
+   * thread drains the queue in batches, so concurrent FlushPage calls coalesce into one combined,
+   * sorted write instead of serializing on the disk manager one page at a time.
+   */
+  std::vector<std::pair<page_id_t, frame_id_t>> flush_queue_;
+  std::mutex flush_mutex_;
+  std::condition_variable flush_cv_;       // wakes the writeback thread
+  std::condition_variable flush_done_cv_;  // wakes FlushPage callers
+  uint64_t flush_gen_{1};                  // generation assigned to enqueued requests
+  uint64_t flush_completed_{0};            // highest generation fully written back
+  bool flush_shutdown_{false};
+  std::thread writeback_thread_;
+
+  /**
+   * Prefetch state: hinted page ids serviced by a dedicated background thread, mirroring the
+   * writeback thread above but on the read side.
+   */
+  std::vector<page_id_t> prefetch_queue_;
+  std::mutex prefetch_mutex_;
+  std::condition_variable prefetch_cv_;
+  bool prefetch_shutdown_{false};
+  std::thread prefetch_thread_;
+
+  /** @brief Writeback thread main loop: drain the flush queue one coalesced batch at a time. */
+  void WritebackLoop();
+
+  /** @brief Prefetch thread main loop: fetch hinted pages and immediately unpin them. */
+  void PrefetchLoop();
+
+  /** @brief Write one batch of flush requests, re-validating each mapping under the shard latches. */
+  void WriteFlushBatch(std::vector<std::pair<page_id_t, frame_id_t>> *batch);
+
+  /** @brief Set the dirty bit of a frame. */
+  void MarkDirtyBit(frame_id_t frame_id) {
+    dirty_bits_[frame_id >> 6].fetch_or(uint64_t{1} << (frame_id & 63), std::memory_order_relaxed);
+  }
+
+  /** @brief Clear the dirty bit of a frame. */
+  void ClearDirtyBit(frame_id_t frame_id) {
+    dirty_bits_[frame_id >> 6].fetch_and(~(uint64_t{1} << (frame_id & 63)), std::memory_order_relaxed);
+  }
+
+  /** @brief Return the page table shard that owns page_id. */
+  auto ShardFor(page_id_t page_id) -> PageTableShard & {
+    return shards_[static_cast<size_t>(page_id) & (NUM_SHARDS - 1)];
+  }
+
+  /**
+   * @brief Claim a free frame, evicting a victim page if necessary. Must be called without holding
+   * any shard latch. On success the frame is not referenced by any page table shard or the replacer.
+   * @param[out] frame_id id of the claimed frame
+   * @return false if no frame could be claimed, true otherwise
+   */
+  auto AcquireFrame(frame_id_t *frame_id) -> bool;
+
+  /** @brief Return a frame claimed by AcquireFrame back to the free list. */
+  void ReleaseFrame(frame_id_t frame_id);
 
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Allocate a page on disk. Mints the next page id with a single atomic increment, so no
+   * latch is required.
    * @return the id of the allocated page
    */
   auto AllocatePage() -> page_id_t;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Deallocate a page on disk. No latch is required.
    * @param page_id id of the page to deallocate
    */
   void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
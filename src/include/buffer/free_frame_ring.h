@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_frame_ring.h
+//
+// Identification: src/include/buffer/free_frame_ring.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * A lock-free bounded multi-producer/multi-consumer ring of free frame ids.
+ *
+ * This is the classic sequence-number ring: each cell carries a sequence counter that encodes
+ * whether it is ready for a push or a pop at the producer/consumer's current position, so both
+ * operations complete with one CAS on the position counter and never take a lock. The capacity is
+ * fixed at construction; the buffer pool can hold at most pool_size free frames, so a push can
+ * only fail if a frame id is double-freed.
+ */
+class FreeFrameRing {
+ public:
+  /** @brief Create a ring with room for at least capacity frame ids. */
+  explicit FreeFrameRing(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+      size *= 2;
+    }
+    mask_ = size - 1;
+    cells_ = std::make_unique<Cell[]>(size);
+    for (size_t i = 0; i < size; ++i) {
+      cells_[i].seq_.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Push a free frame id.
+   * @return false if the ring is full (which indicates a double-free)
+   */
+  auto Push(frame_id_t frame_id) -> bool {
+    auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell *cell = &cells_[pos & mask_];
+      auto seq = cell->seq_.load(std::memory_order_acquire);
+      auto dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (dif == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          cell->value_ = frame_id;
+          cell->seq_.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (dif < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Pop a free frame id.
+   * @param[out] frame_id the popped frame id
+   * @return false if the ring is empty
+   */
+  auto Pop(frame_id_t *frame_id) -> bool {
+    auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell *cell = &cells_[pos & mask_];
+      auto seq = cell->seq_.load(std::memory_order_acquire);
+      auto dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (dif == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          *frame_id = cell->value_;
+          cell->seq_.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (dif < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> seq_;
+    frame_id_t value_;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+  /** Producer and consumer cursors on separate cachelines so pushes and pops do not false-share. */
+  alignas(64) std::atomic<size_t> enqueue_pos_{0};
+  alignas(64) std::atomic<size_t> dequeue_pos_{0};
+};
+
+}  // namespace bustub
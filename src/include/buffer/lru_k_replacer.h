@@ -12,10 +12,14 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <limits>
-#include <list>
 #include <mutex>  // NOLINT
+#include <optional>
+#include <set>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "common/config.h"
@@ -28,18 +32,50 @@ enum class AccessType { Unknown = 0, Get, Scan };
 class LRUKNode {
   friend class LRUKReplacer;
 
+ public:
+  /** Maximum supported lookback window. Must be a power of two. */
+  static constexpr size_t MAX_K = 16;
+
+  LRUKNode() = default;
+  explicit LRUKNode(frame_id_t frame_id) : fid_(frame_id) {}
+
  private:
-  /** History of last seen K timestamps of this page. Least recent timestamp stored in front. */
-  // Remove maybe_unused if you start using them. Feel free to change the member variables as you want.
+  /** @brief Record an access timestamp, keeping at most k entries. */
+  void PushFront(size_t timestamp, size_t k) {
+    head_ = (head_ - 1) & (MAX_K - 1);
+    hist_[head_] = timestamp;
+    if (size_ < k) {
+      size_++;
+    }
+  }
+
+  /** @brief Overwrite the most recent timestamp in place; only valid when k == 1. */
+  void Touch(size_t timestamp) { hist_[head_] = timestamp; }
+
+  /** @return the oldest retained timestamp: the kth most recent access once the history is full */
+  auto Back() const -> size_t { return hist_[(head_ + size_ - 1) & (MAX_K - 1)]; }
+
+  /** @return the number of retained timestamps */
+  auto HistorySize() const -> size_t { return size_; }
 
-  std::list<size_t> history_;  // front insert
-  [[maybe_unused]] size_t k_;
+  /**
+   * History of the last seen K timestamps of this page, stored in a fixed ring buffer with the
+   * most recent access at head_. A ring avoids the per-access node allocation and pointer chasing
+   * of a linked list; overwriting the slot past the tail replaces the old pop_back.
+   */
+  std::array<size_t, MAX_K> hist_{};
+  uint8_t head_{0};
+  uint8_t size_{0};
+  /**
+   * Clock-style usage credit, saturating at MAX_USAGE. Only the batched access path charges it;
+   * Evict gives frames with outstanding credit a second chance, decrementing as the sweep passes,
+   * the way the PostgreSQL clock sweep treats usage_count.
+   */
+  uint8_t usage_count_{0};
   frame_id_t fid_;
   bool is_evictable_{false};
 
- public:
-  LRUKNode() = default;
-  explicit LRUKNode(frame_id_t frame_id) : fid_(frame_id) {}
+  static constexpr uint8_t MAX_USAGE = 5;
 };
 
 /**
@@ -106,6 +142,18 @@ class LRUKReplacer {
    */
   void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown);
 
+  /**
+   * @brief Record a batch of accesses under a single latch acquisition.
+   *
+   * Events are applied in order with consecutive timestamps. Frames without an entry in the
+   * replacer are skipped: batched events may be flushed after the frame they refer to has been
+   * evicted, and replacement history for a dead frame is meaningless.
+   *
+   * @param frames pointer to the frame ids accessed, oldest first
+   * @param n number of events
+   */
+  void RecordAccessBatch(const frame_id_t *frames, size_t n);
+
   /**
    * TODO(P1): Add implementation
    *
@@ -154,13 +202,43 @@ class LRUKReplacer {
   auto Size() -> size_t;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
+  /**
+   * Eviction-order key: the node's kth-ago (or earliest) timestamp in the high bits and its frame
+   * id in the low 32, SWAR-packed into one integer so ordered-set comparisons are a single
+   * branchless integer compare instead of a two-field lexicographic one.
+   */
+  using EvictionKey = unsigned __int128;
+
+  /** @return the packed eviction-order key of a node */
+  static auto KeyOf(const LRUKNode &node) -> EvictionKey;
+
+  /** @brief Add an evictable node to the ordered candidate set matching its history length. */
+  void InsertKey(const LRUKNode &node);
+
+  /** @brief Remove an evictable node from the ordered candidate set matching its history length. */
+  void EraseKey(const LRUKNode &node);
+
+  /**
+   * @brief Sweep a candidate set in eviction order, honoring usage credit: frames with outstanding
+   * credit are decremented and passed over, so recently hot pages survive a burst of evictions.
+   * @return the chosen frame id, or std::nullopt if the set is empty
+   */
+  auto SweepVictim(const std::set<EvictionKey> &candidates) -> std::optional<frame_id_t>;
+
   std::unordered_map<frame_id_t, LRUKNode> node_store_;
+  /**
+   * Evictable frames, ordered by eviction preference. Frames with fewer than k recorded accesses
+   * have +inf backward k-distance and live in inf_set_, keyed by earliest access (classical LRU).
+   * Frames with a full history live in finite_set_, keyed by their kth most recent access, so the
+   * frame with the largest backward k-distance is always *finite_set_.begin(). This makes Evict
+   * O(log N) instead of a linear scan over node_store_.
+   */
+  std::set<EvictionKey> inf_set_;
+  std::set<EvictionKey> finite_set_;
   size_t current_timestamp_{0};
   size_t curr_size_{0};
   [[maybe_unused]] size_t replacer_size_;
-  [[maybe_unused]] size_t k_;
+  size_t k_;
   std::mutex latch_;
 };
 
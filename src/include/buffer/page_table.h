@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * An open-addressed, linear-probing page_id -> frame_id table used by the buffer pool manager.
+ *
+ * Entries are stored inline in a single contiguous array of {page_id, frame_id} slots, so a lookup
+ * touches one cacheline in the common case instead of chasing a bucket pointer the way
+ * std::unordered_map does. Empty slots are marked with INVALID_PAGE_ID; erasure uses backward
+ * shifting so no tombstones accumulate. The table doubles once it is half full, keeping probe
+ * sequences short.
+ */
+class PageTable {
+ public:
+  /** @brief Create a table with room for expected_entries before the first grow. */
+  explicit PageTable(size_t expected_entries = 8) { Reserve(expected_entries); }
+
+  /** @brief Ensure capacity for expected_entries without rehashing on insert. */
+  void Reserve(size_t expected_entries) {
+    size_t capacity = 16;
+    while (capacity < expected_entries * 2) {
+      capacity *= 2;
+    }
+    if (capacity <= slots_.size()) {
+      return;
+    }
+    Rehash(capacity);
+  }
+
+  /**
+   * @brief Prefetch the slot a lookup of page_id will probe first. Useful for hiding the cache
+   * miss on the slot array behind the shard latch acquisition.
+   */
+  void Prefetch(page_id_t page_id) const { __builtin_prefetch(&slots_[IndexFor(page_id)], 0, 0); }
+
+  /**
+   * @brief Look up a page id.
+   * @return pointer to the frame id slot, or nullptr if the page is not present
+   */
+  auto Find(page_id_t page_id) -> frame_id_t * {
+    auto i = IndexFor(page_id);
+    while (slots_[i].page_id_ != INVALID_PAGE_ID) {
+      if (slots_[i].page_id_ == page_id) {
+        return &slots_[i].frame_id_;
+      }
+      i = (i + 1) & mask_;
+    }
+    return nullptr;
+  }
+
+  /** @brief Insert a mapping, overwriting the frame id if the page is already present. */
+  void Insert(page_id_t page_id, frame_id_t frame_id) {
+    auto i = IndexFor(page_id);
+    while (slots_[i].page_id_ != INVALID_PAGE_ID) {
+      if (slots_[i].page_id_ == page_id) {
+        slots_[i].frame_id_ = frame_id;
+        return;
+      }
+      i = (i + 1) & mask_;
+    }
+    slots_[i] = {page_id, frame_id};
+    size_++;
+    if (size_ * 2 > slots_.size()) {
+      Rehash(slots_.size() * 2);
+    }
+  }
+
+  /**
+   * @brief Erase a mapping, backward-shifting displaced slots to keep probe chains intact.
+   * @return true if the page was present
+   */
+  auto Erase(page_id_t page_id) -> bool {
+    auto hole = IndexFor(page_id);
+    while (slots_[hole].page_id_ != page_id) {
+      if (slots_[hole].page_id_ == INVALID_PAGE_ID) {
+        return false;
+      }
+      hole = (hole + 1) & mask_;
+    }
+    auto i = (hole + 1) & mask_;
+    while (slots_[i].page_id_ != INVALID_PAGE_ID) {
+      // Move a slot back into the hole only if doing so does not place it before its home index.
+      auto home = IndexFor(slots_[i].page_id_);
+      if (((i - home) & mask_) >= ((i - hole) & mask_)) {
+        slots_[hole] = slots_[i];
+        hole = i;
+      }
+      i = (i + 1) & mask_;
+    }
+    slots_[hole].page_id_ = INVALID_PAGE_ID;
+    size_--;
+    return true;
+  }
+
+  /** @return the number of mappings in the table */
+  auto Size() const -> size_t { return size_; }
+
+ private:
+  struct Slot {
+    page_id_t page_id_{INVALID_PAGE_ID};
+    frame_id_t frame_id_{0};
+  };
+
+  /** @brief Fibonacci-hash the page id into a slot index. */
+  auto IndexFor(page_id_t page_id) const -> size_t {
+    return static_cast<size_t>((static_cast<uint64_t>(page_id) * 0x9E3779B97F4A7C15ULL) >> 32) & mask_;
+  }
+
+  /** @brief Resize the slot array to capacity (a power of two) and reinsert all mappings. */
+  void Rehash(size_t capacity) {
+    std::vector<Slot> old_slots = std::move(slots_);
+    slots_.assign(capacity, Slot{});
+    mask_ = capacity - 1;
+    for (const auto &slot : old_slots) {
+      if (slot.page_id_ != INVALID_PAGE_ID) {
+        auto i = IndexFor(slot.page_id_);
+        while (slots_[i].page_id_ != INVALID_PAGE_ID) {
+          i = (i + 1) & mask_;
+        }
+        slots_[i] = slot;
+      }
+    }
+  }
+
+  /** Slot array; its size is always a power of two. */
+  std::vector<Slot> slots_;
+  /** Number of occupied slots. */
+  size_t size_{0};
+  /** slots_.size() - 1, for masking probe indices. */
+  size_t mask_{0};
+};
+
+}  // namespace bustub
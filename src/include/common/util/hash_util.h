@@ -38,6 +38,17 @@ class HashUtil {
     return hash;
   }
 
+  /** @return a strong 64-bit mix of the word (the splitmix64 finalizer). Meant as the single
+   * final scramble over values that were cheaply folded together beforehand. */
+  static inline auto Mix64(uint64_t x) -> hash_t {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return static_cast<hash_t>(x);
+  }
+
   static inline auto CombineHashes(hash_t l, hash_t r) -> hash_t {
     hash_t both[2] = {};
     both[0] = l;
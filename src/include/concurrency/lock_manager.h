@@ -13,12 +13,15 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <condition_variable>  // NOLINT
-#include <list>
+#include <functional>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <set>
+#include <shared_mutex>  // NOLINT
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -62,14 +65,157 @@ class LockManager {
     RID rid_;
     /** Whether the lock has been granted or not */
     bool granted_{false};
+    /**
+     * The requesting transaction waits on its own condition variable, so releasing a lock can wake
+     * exactly the waiters that became compatible instead of notify_all-ing the whole queue.
+     */
+    std::condition_variable cv_;
   };
 
   class LockRequestQueue {
    public:
-    /** List of lock requests for the same resource (table or row) */
-    std::list<LockRequest *> request_queue_;
-    /** For notifying blocked transactions on this rid */
-    std::condition_variable cv_;
+    /** Maximum number of released LockRequest nodes kept for reuse. */
+    static constexpr size_t MAX_POOLED_REQUESTS = 64;
+
+    /** Position marker for "this transaction has no request in the queue". */
+    static constexpr size_t INVALID_POS = std::numeric_limits<size_t>::max();
+
+    /** Low 3 bits of a packed flags byte hold the LockMode. */
+    static constexpr uint8_t MODE_MASK = 0x07;
+    /** Bit 7 of a packed flags byte is set while the request is granted. */
+    static constexpr uint8_t GRANTED_BIT = 0x80;
+
+    /** @return a request's mode and granted state packed into one byte */
+    static auto PackFlags(LockMode lock_mode, bool granted) -> uint8_t {
+      return static_cast<uint8_t>(static_cast<uint8_t>(lock_mode) | (granted ? GRANTED_BIT : 0));
+    }
+
+    ~LockRequestQueue() {
+      for (auto *lock_request : request_queue_) {
+        delete lock_request;
+      }
+      for (auto *lock_request : free_requests_) {
+        delete lock_request;
+      }
+    }
+
+    /**
+     * @brief Get a request node, reusing a previously released one when available so the lock
+     * path does not hit the allocator on every acquire. Must be called with the queue latch held.
+     */
+    auto AllocRequest(txn_id_t txn_id, LockMode lock_mode, table_oid_t oid, RID rid = RID{}) -> LockRequest * {
+      if (free_requests_.empty()) {
+        return new LockRequest(txn_id, lock_mode, oid, rid);
+      }
+      auto *lock_request = free_requests_.back();
+      free_requests_.pop_back();
+      lock_request->txn_id_ = txn_id;
+      lock_request->lock_mode_ = lock_mode;
+      lock_request->oid_ = oid;
+      lock_request->rid_ = rid;
+      lock_request->granted_ = false;
+      return lock_request;
+    }
+
+    /**
+     * @brief Return a request node to the free list. The node must already be out of the queue
+     * and have no waiter blocked on its condition variable. Must be called with the queue latch
+     * held.
+     */
+    void FreeRequest(LockRequest *lock_request) {
+      if (free_requests_.size() >= MAX_POOLED_REQUESTS) {
+        delete lock_request;
+        return;
+      }
+      free_requests_.push_back(lock_request);
+    }
+
+    /** @brief Append a request to the queue and index it by transaction id. */
+    void Enqueue(LockRequest *lock_request) {
+      by_txn_.emplace(lock_request->txn_id_, request_queue_.size());
+      hot_txn_ids_.push_back(lock_request->txn_id_);
+      hot_flags_.push_back(PackFlags(lock_request->lock_mode_, lock_request->granted_));
+      request_queue_.push_back(lock_request);
+    }
+
+    /**
+     * @brief Erase the request at a position. Later entries shift down one slot, preserving the
+     * FIFO order the grant policy depends on (a swap-with-back erase would not), so their index
+     * entries are refreshed; queues are short enough that this beats losing fairness.
+     * Does not delete the request.
+     */
+    void Erase(size_t pos) {
+      by_txn_.erase(request_queue_[pos]->txn_id_);
+      request_queue_.erase(request_queue_.begin() + static_cast<ptrdiff_t>(pos));
+      hot_txn_ids_.erase(hot_txn_ids_.begin() + static_cast<ptrdiff_t>(pos));
+      hot_flags_.erase(hot_flags_.begin() + static_cast<ptrdiff_t>(pos));
+      for (size_t i = pos; i < request_queue_.size(); ++i) {
+        by_txn_[request_queue_[i]->txn_id_] = i;
+      }
+    }
+
+    /** @return position of the transaction's request, or INVALID_POS if it has none */
+    auto FindRequest(txn_id_t txn_id) -> size_t {
+      auto iterator = by_txn_.find(txn_id);
+      return iterator == by_txn_.end() ? INVALID_POS : iterator->second;
+    }
+
+    /** @brief Mirror a request's granted_/lock_mode_ mutation into its packed flags byte. */
+    void SyncHot(size_t pos) {
+      const auto *lock_request = request_queue_[pos];
+      hot_flags_[pos] = PackFlags(lock_request->lock_mode_, lock_request->granted_);
+    }
+
+    /** @brief Drop all requests and the index. Does not delete the requests. */
+    void Clear() {
+      request_queue_.clear();
+      hot_txn_ids_.clear();
+      hot_flags_.clear();
+      by_txn_.clear();
+      granted_count_.fill(0);
+      granted_mask_ = 0;
+    }
+
+    /** @brief Account for a request of the given mode becoming granted. */
+    void OnGrant(LockMode mode) {
+      granted_count_[static_cast<uint8_t>(mode)]++;
+      granted_mask_ |= static_cast<uint8_t>(1U << static_cast<uint8_t>(mode));
+    }
+
+    /** @brief Account for a granted request of the given mode being released or revoked. */
+    void OnRevoke(LockMode mode) {
+      if (--granted_count_[static_cast<uint8_t>(mode)] == 0) {
+        granted_mask_ &= static_cast<uint8_t>(~(1U << static_cast<uint8_t>(mode)));
+      }
+    }
+
+    /** Lock requests for the same resource (table or row), in FIFO order. */
+    std::vector<LockRequest *> request_queue_;
+    /**
+     * Hot fields of each request, split from LockRequest into parallel arrays so the
+     * compatibility scans never chase a request pointer (whose condition variable alone spans a
+     * cache line). The flags bytes pack mode and granted state 64 entries per cache line, and the
+     * branchless scan over them is plain enough for the compiler to vectorize.
+     */
+    std::vector<txn_id_t> hot_txn_ids_;
+    std::vector<uint8_t> hot_flags_;
+    /**
+     * Position of each transaction's request in request_queue_. A transaction holds at most one
+     * request per resource, so locating one's own request is a hash lookup instead of an O(N)
+     * walk. Maintained by Enqueue/Erase/Clear; code that mutates request_queue_ must go through
+     * them.
+     */
+    std::unordered_map<txn_id_t, size_t> by_txn_;
+    /**
+     * Number of granted requests per lock mode, and a mask with one bit per mode that currently
+     * has at least one grant. Compatibility against the whole granted set is then a single mask
+     * test instead of a walk over every granted request. Kept in sync by OnGrant/OnRevoke at every
+     * granted_ transition.
+     */
+    std::array<uint16_t, 5> granted_count_{};
+    uint8_t granted_mask_{0};
+    /** Released request nodes awaiting reuse; their condition variables are idle. */
+    std::vector<LockRequest *> free_requests_;
     /** txn_id of an upgrading transaction (if any) */
     txn_id_t upgrading_ = INVALID_TXN_ID;
     /** coordination */
@@ -79,7 +225,18 @@ class LockManager {
   /**
    * Creates a new lock manager configured for the deadlock detection policy.
    */
-  LockManager() = default;
+  LockManager() {
+    // Pre-size every shard map and keep the load factor low so the hot lock path neither rehashes
+    // nor walks long chains while the shard latch is held.
+    for (auto &shard : table_lock_shards_) {
+      shard.map_.reserve(SHARD_INITIAL_CAPACITY);
+      shard.map_.max_load_factor(0.5F);
+    }
+    for (auto &shard : row_lock_shards_) {
+      shard.map_.reserve(SHARD_INITIAL_CAPACITY);
+      shard.map_.max_load_factor(0.5F);
+    }
+  }
 
   void StartDeadlockDetection() {
     BUSTUB_ENSURE(txn_manager_ != nullptr, "txn_manager_ is not set.")
@@ -316,6 +473,31 @@ class LockManager {
  private:
   /** Spring 2023 */
   /* You are allowed to modify all functions below. */
+
+  /** Outcome of a throw-free lock operation. */
+  enum class LockOutcome {
+    SUCCESS,
+    /** The request failed without a protocol violation (the transaction was already aborted). */
+    FAILURE,
+    /** A locking protocol violation: the caller must abort the transaction with the reported reason. */
+    VIOLATION,
+  };
+
+  /**
+   * Throw-free bodies of the public lock API. A protocol violation is reported by filling *reason
+   * and returning VIOLATION; only the public wrappers translate that into SetState(ABORTED) plus
+   * TransactionAbortException, so the contended paths carry no throw statements and the unwind
+   * edges stay out of the hot code.
+   */
+  auto LockTableInternal(Transaction *txn, LockMode lock_mode, const table_oid_t &oid, AbortReason *reason)
+      -> LockOutcome;
+  auto LockRowInternal(Transaction *txn, LockMode lock_mode, const table_oid_t &oid, const RID &rid,
+                       AbortReason *reason) -> LockOutcome;
+  auto UnlockTableInternal(Transaction *txn, const table_oid_t &oid, AbortReason *reason) -> LockOutcome;
+  auto UnlockRowInternal(Transaction *txn, const table_oid_t &oid, const RID &rid, bool force, AbortReason *reason)
+      -> LockOutcome;
+  auto CanTxnTakeLockInternal(Transaction *txn, LockMode lock_mode, AbortReason *reason) -> LockOutcome;
+
   auto UpgradeLockTable(Transaction *txn, LockMode lock_mode, const table_oid_t &oid) -> bool;
   auto UpgradeLockRow(Transaction *txn, LockMode lock_mode, const table_oid_t &oid, const RID &rid) -> bool;
   auto AreLocksCompatible(LockMode l1, LockMode l2) -> bool;
@@ -334,22 +516,79 @@ class LockManager {
   auto GetLockRequest(LockRequestQueue *lock_request_queue, LockMode lock_mode, txn_id_t txn_id, bool &is_compatible)
       -> LockRequest *;
   auto AreCurrentLockSatisfied(LockMode curr_lock_mode, LockMode requested_lock_mode) -> bool;
-  void BuildGraph();
-
-  /** Structure that holds lock requests for a given table oid */
-  std::unordered_map<table_oid_t, std::shared_ptr<LockRequestQueue>> table_lock_map_;
-  /** Coordination */
-  std::mutex table_lock_map_latch_;
-
-  /** Structure that holds lock requests for a given RID */
-  std::unordered_map<RID, std::shared_ptr<LockRequestQueue>> row_lock_map_;
-  /** Coordination */
-  std::mutex row_lock_map_latch_;
-
-  std::atomic<bool> enable_cycle_detection_;
-  std::thread *cycle_detection_thread_;
-  /** Waits-for graph representation. */
-  std::map<txn_id_t, std::set<txn_id_t>> waits_for_;
+
+  /**
+   * @brief Rebuild the waiter's adjacency in the waits-for graph from the queue's current
+   * blockers and remember which queue it waits on. Called with the queue latch held each time
+   * the waiter is about to block, so the graph tracks waits as they happen and the detector
+   * never has to rescan every lock queue.
+   */
+  void RefreshWaitEdges(LockRequestQueue *lock_request_queue, LockRequest *waiter);
+
+  /** @brief Drop the transaction's waits-for adjacency and waiting-queue entry once it stops waiting. */
+  void ClearWaitEdges(txn_id_t txn_id);
+
+  /** Number of partitions of each lock map. Must be a power of two so shard selection is a mask. */
+  static constexpr size_t LOCK_MAP_SHARDS = 64;
+
+  /** Initial bucket reservation of each lock map shard. */
+  static constexpr size_t SHARD_INITIAL_CAPACITY = 16;
+
+  /**
+   * One partition of a lock map, aligned to a cacheline so neighboring shards' latches never
+   * false-share. Splitting the single map latch this way means transactions locking unrelated
+   * resources hash to different shards and proceed without contending. The latch is a
+   * reader-writer lock: steady-state traffic is lookups of existing queues, which take shared
+   * mode; only queue creation takes it exclusively.
+   */
+  template <typename KeyType>
+  struct alignas(64) LockMapShard {
+    std::shared_mutex latch_;
+    /**
+     * Queues are created on first use and never erased, so they live as long as the manager and
+     * the map can own them outright; lookups hand out raw pointers without the atomic refcount
+     * bump a shared_ptr copy would cost on every lock and unlock.
+     */
+    std::unordered_map<KeyType, std::unique_ptr<LockRequestQueue>> map_;
+  };
+
+  /** @return the shard of the table lock map that owns oid */
+  auto TableShardFor(const table_oid_t &oid) -> LockMapShard<table_oid_t> & {
+    return table_lock_shards_[std::hash<table_oid_t>{}(oid) & (LOCK_MAP_SHARDS - 1)];
+  }
+
+  /** @return the shard of the row lock map that owns rid */
+  auto RowShardFor(const RID &rid) -> LockMapShard<RID> & {
+    return row_lock_shards_[std::hash<RID>{}(rid) & (LOCK_MAP_SHARDS - 1)];
+  }
+
+  // The alignment also rounds each shard's size up to whole cachelines, so adjacent array
+  // elements can never share a line; assert it so a future member doesn't silently regress this.
+  static_assert(sizeof(LockMapShard<table_oid_t>) % 64 == 0, "lock map shards must span whole cachelines");
+  static_assert(sizeof(LockMapShard<RID>) % 64 == 0, "lock map shards must span whole cachelines");
+
+  /** Partitioned structure that holds lock requests for a given table oid */
+  std::array<LockMapShard<table_oid_t>, LOCK_MAP_SHARDS> table_lock_shards_;
+
+  /** Partitioned structure that holds lock requests for a given RID */
+  std::array<LockMapShard<RID>, LOCK_MAP_SHARDS> row_lock_shards_;
+
+  // Explicitly initialized: with a user-provided constructor these are no longer zeroed by
+  // value-initialization, and the destructor dereferences the thread pointer.
+  std::atomic<bool> enable_cycle_detection_{false};
+  std::thread *cycle_detection_thread_{nullptr};
+  /**
+   * Waits-for graph representation. Keys stay in a std::map so detection visits transactions in
+   * ascending id order deterministically; adjacency lists are sorted, deduplicated vectors
+   * instead of per-node tree sets, so edge scans are contiguous loads.
+   */
+  std::map<txn_id_t, std::vector<txn_id_t>> waits_for_;
+  /**
+   * The queue each currently blocked transaction is waiting on, maintained alongside waits_for_
+   * so the detector can wake a deadlock victim directly. Queues are never destroyed, so the raw
+   * pointer stays valid after waits_for_latch_ is dropped.
+   */
+  std::unordered_map<txn_id_t, LockRequestQueue *> waiting_on_;
   std::mutex waits_for_latch_;
 };
 
@@ -78,19 +78,17 @@ class TableWriteRecord {
 };
 
 /**
- * WriteRecord tracks information related to a write.
+ * WriteRecord tracks information related to a write. The index key is not stored here: its
+ * serialized bytes live in the transaction's shared key arena at key_offset_, so appending a
+ * record costs no heap allocation of its own (see Transaction::AppendIndexWriteRecord).
  */
 class IndexWriteRecord {
  public:
   // NOLINTNEXTLINE
-  IndexWriteRecord(RID rid, table_oid_t table_oid, WType wtype, const Tuple &tuple, index_oid_t index_oid,
-                   Catalog *catalog)
-      : rid_(rid), table_oid_(table_oid), wtype_(wtype), tuple_(tuple), index_oid_(index_oid), catalog_(catalog) {}
-
-  /**
-   * Note(spring2023): I don't know what are these for. If you are implementing leaderboard optimizations, you can
-   * figure out how to use this structure to store what you need.
-   */
+  IndexWriteRecord(RID rid, table_oid_t table_oid, WType wtype, index_oid_t index_oid, Catalog *catalog,
+                   uint32_t key_offset)
+      : rid_(rid), table_oid_(table_oid), wtype_(wtype), index_oid_(index_oid), catalog_(catalog),
+        key_offset_(key_offset) {}
 
   /** The rid is the value stored in the index. */
   RID rid_;
@@ -98,14 +96,12 @@ class IndexWriteRecord {
   table_oid_t table_oid_;
   /** Write type. */
   WType wtype_;
-  /** The tuple is used to construct an index key. */
-  Tuple tuple_;
-  /** The old tuple is only used for the update operation. */
-  Tuple old_tuple_;
   /** Each table has an index list, this is the identifier of an index into the list. */
   index_oid_t index_oid_;
   /** The catalog contains metadata required to locate index. */
   Catalog *catalog_;
+  /** Byte offset of the serialized index key in the transaction's key arena. */
+  uint32_t key_offset_;
 };
 
 /**
@@ -179,8 +175,9 @@ class Transaction {
         s_row_lock_set_{new std::unordered_map<table_oid_t, std::unordered_set<RID>>},
         x_row_lock_set_{new std::unordered_map<table_oid_t, std::unordered_set<RID>>} {
     // Initialize the sets that will be tracked.
-    table_write_set_ = std::make_shared<std::deque<TableWriteRecord>>();
-    index_write_set_ = std::make_shared<std::deque<IndexWriteRecord>>();
+    table_write_set_ = std::make_shared<std::vector<TableWriteRecord>>();
+    index_write_set_ = std::make_shared<std::vector<IndexWriteRecord>>();
+    index_key_arena_ = std::make_shared<std::vector<char>>();
     page_set_ = std::make_shared<std::deque<bustub::Page *>>();
     deleted_page_set_ = std::make_shared<std::unordered_set<page_id_t>>();
   }
@@ -199,10 +196,10 @@ class Transaction {
   inline auto GetIsolationLevel() const -> IsolationLevel { return isolation_level_; }
 
   /** @return the list of table write records of this transaction */
-  inline auto GetWriteSet() -> std::shared_ptr<std::deque<TableWriteRecord>> { return table_write_set_; }
+  inline auto GetWriteSet() -> std::shared_ptr<std::vector<TableWriteRecord>> { return table_write_set_; }
 
   /** @return the list of index write records of this transaction */
-  inline auto GetIndexWriteSet() -> std::shared_ptr<std::deque<IndexWriteRecord>> { return index_write_set_; }
+  inline auto GetIndexWriteSet() -> std::shared_ptr<std::vector<IndexWriteRecord>> { return index_write_set_; }
 
   /** @return the page set */
   inline auto GetPageSet() -> std::shared_ptr<std::deque<Page *>> { return page_set_; }
@@ -216,11 +213,35 @@ class Transaction {
   }
 
   /**
-   * Adds an index write record into the index write set.
-   * @param write_record write record to be added
+   * Adds an index write record into the index write set, serializing the index key into the
+   * transaction's key arena. One growing buffer backs every record's key bytes, so appending undo
+   * information does not heap-allocate per record the way storing a Tuple in the record would.
+   * @param rid the rid stored in the index
+   * @param table_oid the table the index belongs to
+   * @param wtype the type of the recorded write
+   * @param key the index key the write touched
+   * @param index_oid the identifier of the index
+   * @param catalog the catalog holding the index metadata
    */
-  inline void AppendIndexWriteRecord(const IndexWriteRecord &write_record) {
-    index_write_set_->push_back(write_record);
+  inline void AppendIndexWriteRecord(RID rid, table_oid_t table_oid, WType wtype, const Tuple &key,
+                                     index_oid_t index_oid, Catalog *catalog) {
+    auto offset = static_cast<uint32_t>(index_key_arena_->size());
+    index_key_arena_->resize(offset + sizeof(int32_t) + key.GetLength());
+    key.SerializeTo(index_key_arena_->data() + offset);
+    index_write_set_->emplace_back(rid, table_oid, wtype, index_oid, catalog, offset);
+  }
+
+  /** @return a deserialized copy of the index key stored for an index write record */
+  inline auto GetIndexWriteKey(const IndexWriteRecord &record) const -> Tuple {
+    Tuple key;
+    key.DeserializeFrom(index_key_arena_->data() + record.key_offset_);
+    return key;
+  }
+
+  /** @brief Drop all index write records along with their arena-backed keys. */
+  inline void ClearIndexWriteSet() {
+    index_write_set_->clear();
+    index_key_arena_->clear();
   }
 
   /**
@@ -304,10 +325,31 @@ class Transaction {
   /** @return the current state of the transaction */
   inline auto GetState() -> TransactionState { return state_; }
 
-  inline auto LockTxn() -> void { latch_.lock(); }
+  inline auto LockTxn() -> void {
+    // Adaptive lock: the critical sections guarded here (write-set edits during commit/abort) are
+    // short and almost always uncontended, so spin briefly on the try_lock fast path — a single
+    // atomic exchange when free — before paying for a blocking lock() and its possible syscall.
+    for (int i = 0; i < TXN_LATCH_SPIN_LIMIT; ++i) {
+      if (latch_.try_lock()) {
+        return;
+      }
+    }
+    latch_.lock();
+  }
 
   inline auto UnlockTxn() -> void { latch_.unlock(); }
 
+  /**
+   * Held-lock accounting, maintained by the lock manager alongside the lock sets. The counter is
+   * read at commit/abort to skip the release walk (and its latching) outright for transactions
+   * holding nothing — the common read-only case. Relaxed ordering suffices: only the owning
+   * thread commits, and its own grants are ordered by program order.
+   */
+  inline void IncHeldLocks() { held_locks_.fetch_add(1, std::memory_order_relaxed); }
+  inline void DecHeldLocks() { held_locks_.fetch_sub(1, std::memory_order_relaxed); }
+  /** @return the number of table and row locks currently held */
+  inline auto GetHeldLocks() const -> uint32_t { return held_locks_.load(std::memory_order_relaxed); }
+
   /**
    * Set the state of the transaction.
    * @param state new state
@@ -334,14 +376,22 @@ class Transaction {
   txn_id_t txn_id_;
 
   /** The undo set of table tuples. */
-  std::shared_ptr<std::deque<TableWriteRecord>> table_write_set_;
+  std::shared_ptr<std::vector<TableWriteRecord>> table_write_set_;
   /** The undo set of indexes. */
-  std::shared_ptr<std::deque<IndexWriteRecord>> index_write_set_;
+  std::shared_ptr<std::vector<IndexWriteRecord>> index_write_set_;
+  /** Serialized index keys for the undo set, appended end to end in one buffer. */
+  std::shared_ptr<std::vector<char>> index_key_arena_;
   /** The LSN of the last record written by the transaction. */
   lsn_t prev_lsn_;
 
+  /** Rounds of try_lock spinning LockTxn attempts before falling back to a blocking lock. */
+  static constexpr int TXN_LATCH_SPIN_LIMIT = 40;
+
   std::mutex latch_;
 
+  /** Number of table and row locks currently held; see IncHeldLocks(). */
+  std::atomic<uint32_t> held_locks_{0};
+
   /** Concurrent index: the pages that were latched during index operation. */
   std::shared_ptr<std::deque<Page *>> page_set_;
   /** Concurrent index: the page IDs that were deleted during index operation.*/
@@ -0,0 +1,201 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// flat_hash_table.h
+//
+// Identification: src/include/container/hash/flat_hash_table.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * FlatHashTable is a small open-addressed hash table for the in-memory executor pipelines
+ * (aggregation build, hash-join build), where insert-or-update throughput dominates.
+ *
+ * Compared to std::unordered_map it keeps keys and values inline in one flat slot array with
+ * linear probing over a power-of-two capacity, so a lookup is one hash, a masked index, and a
+ * short walk over adjacent cache lines instead of a bucket-pointer chase per probe. Each slot has
+ * a control byte in a separate array holding a 7-bit fingerprint of the key's hash (high bit =
+ * occupied), so the probe loop walks only this dense array and touches the (larger) key/value
+ * storage just for slots whose fingerprint already matches — colliding-but-unequal keys are
+ * rejected by a one-byte compare instead of a full key comparison. The executors only build,
+ * iterate, and clear, so there is no erase and no tombstone handling.
+ */
+template <typename KeyType, typename ValueType, typename KeyHash = std::hash<KeyType>>
+class FlatHashTable {
+ public:
+  FlatHashTable() { Reset(INITIAL_CAPACITY); }
+
+  /**
+   * @brief Find the value slot for a key, inserting a default-constructed value if absent.
+   * @return the value slot and whether this call inserted it. The pointer is invalidated by the
+   * next FindOrInsert (a resize may move the slots).
+   */
+  auto FindOrInsert(const KeyType &key) -> std::pair<ValueType *, bool> {
+    if ((size_ + 1) * LOAD_FACTOR_DEN > slots_.size() * LOAD_FACTOR_NUM) {
+      Rehash(slots_.size() * 2);
+    }
+    auto hash = KeyHash{}(key);
+    auto pos = ProbeFor(key, hash);
+    bool inserted = ctrl_[pos] == 0;
+    if (inserted) {
+      ctrl_[pos] = Fingerprint(hash);
+      slots_[pos].key_ = key;
+      size_++;
+    }
+    return {&slots_[pos].value_, inserted};
+  }
+
+  /** @return the value stored under the key, or nullptr if absent */
+  auto Find(const KeyType &key) const -> const ValueType * { return FindWithHash(key, KeyHash{}(key)); }
+
+  /** @return the value stored under the key, or nullptr if absent; `hash` must be the key's
+   * KeyHash value. Lets batched probers hash once, prefetch, and look up later. */
+  auto FindWithHash(const KeyType &key, size_t hash) const -> const ValueType * {
+    auto pos = ProbeFor(key, hash);
+    return ctrl_[pos] != 0 ? &slots_[pos].value_ : nullptr;
+  }
+
+  /** @brief Prefetch the control byte and slot a hash maps to, ahead of a FindWithHash call. */
+  void PrefetchFind(size_t hash) const {
+    auto pos = hash & mask_;
+    __builtin_prefetch(&ctrl_[pos]);
+    __builtin_prefetch(&slots_[pos]);
+  }
+
+  /** @brief Drop all entries, releasing per-slot payloads but keeping the slot capacity. */
+  void Clear() {
+    std::fill(ctrl_.begin(), ctrl_.end(), 0);
+    for (auto &slot : slots_) {
+      slot = Slot{};
+    }
+    size_ = 0;
+  }
+
+  /** @return the number of stored entries */
+  auto Size() const -> size_t { return size_; }
+
+  /**
+   * @brief Size the table up front for an expected number of entries, so a build of known
+   * cardinality does not pay the doubling rehashes on the way up. Grows only (existing entries
+   * are kept); the capacity is the next power of two keeping the load factor below threshold.
+   */
+  void Reserve(size_t expected) {
+    size_t capacity = slots_.size();
+    while (expected * LOAD_FACTOR_DEN > capacity * LOAD_FACTOR_NUM) {
+      capacity *= 2;
+    }
+    if (capacity > slots_.size()) {
+      Rehash(capacity);
+    }
+  }
+
+  /** A const iterator over the occupied slots, in table order */
+  class ConstIterator {
+   public:
+    ConstIterator(const FlatHashTable *table, size_t pos) : table_(table), pos_(pos) { SkipEmpty(); }
+
+    /** @return The key of the iterator */
+    auto Key() const -> const KeyType & { return table_->slots_[pos_].key_; }
+
+    /** @return The value of the iterator */
+    auto Val() const -> const ValueType & { return table_->slots_[pos_].value_; }
+
+    auto operator++() -> ConstIterator & {
+      pos_++;
+      SkipEmpty();
+      return *this;
+    }
+
+    auto operator==(const ConstIterator &other) const -> bool { return pos_ == other.pos_; }
+    auto operator!=(const ConstIterator &other) const -> bool { return pos_ != other.pos_; }
+
+   private:
+    void SkipEmpty() {
+      while (pos_ < table_->ctrl_.size() && table_->ctrl_[pos_] == 0) {
+        pos_++;
+      }
+    }
+
+    const FlatHashTable *table_;
+    size_t pos_;
+  };
+
+  auto Begin() const -> ConstIterator { return {this, 0}; }
+  auto End() const -> ConstIterator { return {this, ctrl_.size()}; }
+
+ private:
+  struct Slot {
+    KeyType key_;
+    ValueType value_;
+  };
+
+  static constexpr size_t INITIAL_CAPACITY = 16;
+  /** Grow at 3/4 occupancy; linear probing clusters badly beyond that. */
+  static constexpr size_t LOAD_FACTOR_NUM = 3;
+  static constexpr size_t LOAD_FACTOR_DEN = 4;
+  /** High bit of a control byte: slot is occupied; low 7 bits hold the hash fingerprint */
+  static constexpr uint8_t OCCUPIED_BIT = 0x80;
+
+  /** @return the control byte for an occupied slot: occupied bit | top 7 bits of the hash. The
+   * fingerprint draws from the high hash bits because the low bits already picked the slot. */
+  static auto Fingerprint(size_t hash) -> uint8_t {
+    return static_cast<uint8_t>((hash >> 57) | static_cast<size_t>(OCCUPIED_BIT));
+  }
+
+  /** @return the slot holding the key, or the empty slot where it would be inserted */
+  auto ProbeFor(const KeyType &key, size_t hash) const -> size_t {
+    const uint8_t fingerprint = Fingerprint(hash);
+    auto pos = hash & mask_;
+    while (ctrl_[pos] != 0) {
+      if (ctrl_[pos] == fingerprint && slots_[pos].key_ == key) {
+        break;
+      }
+      pos = (pos + 1) & mask_;
+    }
+    return pos;
+  }
+
+  void Reset(size_t capacity) {
+    ctrl_.assign(capacity, 0);
+    slots_.clear();
+    slots_.resize(capacity);
+    mask_ = capacity - 1;
+  }
+
+  void Rehash(size_t new_capacity) {
+    auto old_ctrl = std::move(ctrl_);
+    auto old_slots = std::move(slots_);
+    Reset(new_capacity);
+    for (size_t i = 0; i < old_slots.size(); ++i) {
+      if (old_ctrl[i] != 0) {
+        auto hash = KeyHash{}(old_slots[i].key_);
+        auto pos = ProbeFor(old_slots[i].key_, hash);
+        ctrl_[pos] = Fingerprint(hash);
+        slots_[pos] = std::move(old_slots[i]);
+      }
+    }
+  }
+
+  /** Per-slot control bytes (empty marker or occupied-bit | fingerprint); the probe loop reads
+   * only this array until the fingerprint hits */
+  std::vector<uint8_t> ctrl_;
+  /** Inline key/value storage, parallel to ctrl_ */
+  std::vector<Slot> slots_;
+  size_t size_{0};
+  size_t mask_{0};
+};
+
+}  // namespace bustub
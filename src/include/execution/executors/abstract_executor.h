@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <optional>
+#include <vector>
+
 #include "execution/executor_context.h"
 #include "storage/table/tuple.h"
 
@@ -47,6 +50,30 @@ class AbstractExecutor {
    */
   virtual auto Next(Tuple *tuple, RID *rid) -> bool = 0;
 
+  /**
+   * Yield up to `max` tuples from this executor in one call, so blocking consumers that drain
+   * their whole child pay one virtual dispatch per batch instead of per row. The default loops
+   * over Next() so every executor supports it; leaf executors may override.
+   * @param[out] tuples Cleared, then filled with the produced tuples
+   * @param max The maximum number of tuples to produce
+   * @return `true` if at least one tuple was produced
+   */
+  virtual auto NextBatch(std::vector<Tuple> *tuples, size_t max) -> bool {
+    tuples->clear();
+    Tuple tuple;
+    RID rid;
+    while (tuples->size() < max && Next(&tuple, &rid)) {
+      tuples->emplace_back(std::move(tuple));
+    }
+    return !tuples->empty();
+  }
+
+  /**
+   * @return An estimate of how many tuples this executor will produce, if one is available.
+   * Used by blocking consumers to pre-size their buffers; never affects query results.
+   */
+  virtual auto EstimatedCardinality() const -> std::optional<size_t> { return std::nullopt; }
+
   /** @return The schema of the tuples that this executor produces */
   virtual auto GetOutputSchema() const -> const Schema & = 0;
 
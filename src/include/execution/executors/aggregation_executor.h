@@ -13,11 +13,11 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "common/util/hash_util.h"
+#include "container/hash/flat_hash_table.h"
 #include "container/hash/hash_function.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -65,7 +65,10 @@ class SimpleAggregationHashTable {
 
   void Init() {
     AggregateKey agg_key;
-    ht_.insert({agg_key, GenerateInitialAggregateValue()});
+    auto slot = ht_.FindOrInsert(agg_key);
+    if (slot.second) {
+      *slot.first = GenerateInitialAggregateValue();
+    }
   }
 
   /**
@@ -138,28 +141,38 @@ class SimpleAggregationHashTable {
    * @param agg_val the value to be inserted
    */
   void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht_.count(agg_key) == 0) {
-      ht_.insert({agg_key, GenerateInitialAggregateValue()});
+    auto slot = ht_.FindOrInsert(agg_key);
+    if (slot.second) {
+      *slot.first = GenerateInitialAggregateValue();
     }
-    CombineAggregateValues(&ht_[agg_key], agg_val);
+    CombineAggregateValues(slot.first, agg_val);
+  }
+
+  /**
+   * Inserts an already-combined partial aggregate under a key not yet in this table; used when
+   * merging disjoint partition tables. Going through InsertCombine instead would re-apply the
+   * per-row combine semantics (COUNT would add one per merged group) to a finished accumulator.
+   */
+  void InsertPartial(const AggregateKey &agg_key, const AggregateValue &agg_val) {
+    *ht_.FindOrInsert(agg_key).first = agg_val;
   }
 
   /**
    * Clear the hash table
    */
-  void Clear() { ht_.clear(); }
+  void Clear() { ht_.Clear(); }
 
   /** An iterator over the aggregation hash table */
   class Iterator {
    public:
-    /** Creates an iterator for the aggregate map. */
-    explicit Iterator(std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter) : iter_{iter} {}
+    /** Creates an iterator for the aggregate table. */
+    explicit Iterator(FlatHashTable<AggregateKey, AggregateValue>::ConstIterator iter) : iter_{iter} {}
 
     /** @return The key of the iterator */
-    auto Key() -> const AggregateKey & { return iter_->first; }
+    auto Key() -> const AggregateKey & { return iter_.Key(); }
 
     /** @return The value of the iterator */
-    auto Val() -> const AggregateValue & { return iter_->second; }
+    auto Val() -> const AggregateValue & { return iter_.Val(); }
 
     /** @return The iterator before it is incremented */
     auto operator++() -> Iterator & {
@@ -174,19 +187,19 @@ class SimpleAggregationHashTable {
     auto operator!=(const Iterator &other) -> bool { return this->iter_ != other.iter_; }
 
    private:
-    /** Aggregates map */
-    std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter_;
+    /** Aggregates table */
+    FlatHashTable<AggregateKey, AggregateValue>::ConstIterator iter_;
   };
 
   /** @return Iterator to the start of the hash table */
-  auto Begin() -> Iterator { return Iterator{ht_.cbegin()}; }
+  auto Begin() -> Iterator { return Iterator{ht_.Begin()}; }
 
   /** @return Iterator to the end of the hash table */
-  auto End() -> Iterator { return Iterator{ht_.cend()}; }
+  auto End() -> Iterator { return Iterator{ht_.End()}; }
 
  private:
   /** The hash table is just a map from aggregate keys to aggregate values */
-  std::unordered_map<AggregateKey, AggregateValue> ht_{};
+  FlatHashTable<AggregateKey, AggregateValue> ht_{};
   /** The aggregate expressions that we have */
   const std::vector<AbstractExpressionRef> &agg_exprs_;
   /** The types of aggregations that we have */
@@ -245,6 +258,11 @@ class AggregationExecutor : public AbstractExecutor {
   }
 
  private:
+  /** Number of child tuples pulled and evaluated per build batch */
+  static constexpr size_t BATCH_SIZE = 1024;
+  /** Number of disjoint partition tables the build folds into before the final merge */
+  static constexpr size_t NUM_PARTITIONS = 8;
+
   /** The aggregation plan node */
   const AggregationPlanNode *plan_;
   /** The child executor that produces tuples over which the aggregation is computed */
@@ -253,5 +271,10 @@ class AggregationExecutor : public AbstractExecutor {
   SimpleAggregationHashTable aht_;
   /** Simple aggregation hash table iterator */
   SimpleAggregationHashTable::Iterator aht_iterator_;
+  /** The inferred output schema, computed once at construction; Next() builds one tuple per group
+   * and must not re-infer (and re-allocate) the schema per row. */
+  Schema output_schema_cached_;
+  /** Reused output-row buffer so Next() does not allocate a fresh vector per emitted tuple */
+  std::vector<Value> values_scratch_;
 };
 }  // namespace bustub
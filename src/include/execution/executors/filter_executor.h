@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "execution/executor_context.h"
@@ -48,6 +49,11 @@ class FilterExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /** @return The child's row estimate; the filter can only shrink it, so it stays an upper bound */
+  auto EstimatedCardinality() const -> std::optional<size_t> override {
+    return child_executor_->EstimatedCardinality();
+  }
+
   /** @return The output schema for the filter plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
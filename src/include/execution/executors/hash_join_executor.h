@@ -12,12 +12,13 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "common/util/hash_util.h"
+#include "container/hash/flat_hash_table.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/hash_join_plan.h"
@@ -44,11 +45,33 @@ struct JoinKey {
   }
 };
 
-/** JoinValue represents a value for each of the running Joins */
-struct JoinValue {
-  /** The Join values */
-  std::vector<Value> values_;
+/** Keys with more columns than this fall back to the general JoinKey representation */
+static constexpr size_t MAX_FIXED_JOIN_KEYS = 2;
+
+/**
+ * FixedJoinKey is the compact representation used when every join-key column is a fixed-width
+ * integer: each column is sign-extended into one 64-bit word, so a key is plain inline data
+ * (no Value discriminators, no per-key heap storage) and the whole table stays denser in cache.
+ * Integer widths may differ across the two sides; the sign-extension makes the encodings agree,
+ * matching Value::CompareEquals' numeric promotion.
+ */
+struct FixedJoinKey {
+  std::array<uint64_t, MAX_FIXED_JOIN_KEYS> repr_{};
+  /** Bit i set = column i is NULL. SQL nulls match nothing, so any null key compares unequal
+   * to every key including itself — same behavior the Value path gets from CompareEquals. */
+  uint32_t null_mask_{0};
+
+  auto operator==(const FixedJoinKey &other) const -> bool {
+    // One branchless chain of word ops instead of std::array's element-wise short-circuit loop:
+    // XOR-and-OR folds the 16 key bytes into a single zero test, which the compiler lowers to a
+    // pair of 8-byte compares (or one 128-bit vector compare where SSE is available). Any set
+    // null bit on either side makes the key unequal, matching SQL null semantics.
+    static_assert(MAX_FIXED_JOIN_KEYS == 2, "the unrolled fold below covers exactly two words");
+    const auto diff = (repr_[0] ^ other.repr_[0]) | (repr_[1] ^ other.repr_[1]);
+    return (diff | null_mask_ | other.null_mask_) == 0;
+  }
 };
+
 }  // namespace bustub
 
 namespace std {
@@ -57,6 +80,41 @@ namespace std {
 template <>
 struct hash<bustub::JoinKey> {
   auto operator()(const bustub::JoinKey &join_key) const -> std::size_t {
+    // Fast path for all-integer, non-null keys (the vast majority of joins): fold the raw values
+    // into one 64-bit word with a multiply-add combine and scramble it once at the end, instead
+    // of a TypeId-dispatched HashValue plus a byte-wise CombineHashes per column. Equal keys have
+    // equal types and nullness, so both sides of a join always agree on the path taken.
+    uint64_t fused = 0;
+    bool fusable = true;
+    for (const auto &key : join_key.keys_) {
+      if (key.IsNull()) {
+        fusable = false;
+        break;
+      }
+      switch (key.GetTypeId()) {
+        case bustub::TypeId::TINYINT:
+          fused = fused * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(key.GetAs<int8_t>());
+          break;
+        case bustub::TypeId::SMALLINT:
+          fused = fused * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(key.GetAs<int16_t>());
+          break;
+        case bustub::TypeId::INTEGER:
+          fused = fused * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(key.GetAs<int32_t>());
+          break;
+        case bustub::TypeId::BIGINT:
+          fused = fused * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(key.GetAs<int64_t>());
+          break;
+        default:
+          fusable = false;
+          break;
+      }
+      if (!fusable) {
+        break;
+      }
+    }
+    if (fusable) {
+      return bustub::HashUtil::Mix64(fused);
+    }
     size_t curr_hash = 0;
     for (const auto &key : join_key.keys_) {
       if (!key.IsNull()) {
@@ -66,12 +124,27 @@ struct hash<bustub::JoinKey> {
     return curr_hash;
   }
 };
+
+/** Implements std::hash on FixedJoinKey */
+template <>
+struct hash<bustub::FixedJoinKey> {
+  auto operator()(const bustub::FixedJoinKey &join_key) const -> std::size_t {
+    uint64_t fused = join_key.null_mask_;
+    for (const auto word : join_key.repr_) {
+      fused = fused * 0x9E3779B97F4A7C15ULL + word;
+    }
+    return bustub::HashUtil::Mix64(fused);
+  }
+};
 }  // namespace std
 
 namespace bustub {
 /**
- * A simplified hash table that has all the necessary functionality for join.
+ * A simplified hash table that has all the necessary functionality for join, templated over the
+ * key representation (the compact FixedJoinKey when every key column is a fixed-width integer,
+ * the general JoinKey otherwise).
  */
+template <typename KeyT>
 class SimpleJoinHashTable {
  public:
   /**
@@ -81,35 +154,36 @@ class SimpleJoinHashTable {
   SimpleJoinHashTable() = default;
 
   /**
-   * Inserts a value into the hash table and then combines it with the current Join. Must handle collisions!
+   * Inserts a build-side tuple into the hash table under its join key. The tuple is stored whole
+   * (one buffer copy) rather than exploded into per-column Values; columns are only materialized
+   * when a probe actually emits a joined row.
    * @param join_key the key to be inserted
-   * @param join_val the value to be inserted
+   * @param tuple the build-side tuple to be inserted
    */
-  void Insert(const JoinKey &join_key, const JoinValue &join_val) {
-    if (ht_.count(join_key) == 0) {
-      std::vector<JoinValue> values;
-      values.push_back(join_val);
-      ht_.insert({join_key, values});
-    } else {
-      auto &values = ht_[join_key];
-      values.push_back(join_val);
-    }
-  }
+  void Insert(const KeyT &join_key, const Tuple &tuple) { ht_.FindOrInsert(join_key).first->push_back(tuple); }
 
-  auto GetValue(const JoinKey &join_key) const -> std::vector<JoinValue> {
-    if (ht_.find(join_key) != ht_.end()) {
-      return ht_.at(join_key);
-    }
-    return {};
+  /** @return the build-side tuples matching the key, or nullptr if there are none */
+  auto GetValue(const KeyT &join_key) const -> const std::vector<Tuple> * { return ht_.Find(join_key); }
+
+  /** @return the build-side tuples matching the key, or nullptr; `hash` must be the key's
+   * std::hash value */
+  auto GetValueWithHash(const KeyT &join_key, size_t hash) const -> const std::vector<Tuple> * {
+    return ht_.FindWithHash(join_key, hash);
   }
+
+  /** Prefetch the slot the hash maps to, ahead of a GetValueWithHash call */
+  void Prefetch(size_t hash) const { ht_.PrefetchFind(hash); }
+  /** Pre-size the table for an expected number of distinct build keys */
+  void Reserve(size_t expected) { ht_.Reserve(expected); }
+
   /**
    * Clear the hash table
    */
-  void Clear() { ht_.clear(); }
+  void Clear() { ht_.Clear(); }
 
  private:
-  /** The hash table is just a map from join keys to values */
-  std::unordered_map<JoinKey, std::vector<JoinValue>> ht_{};
+  /** The hash table is just a map from join keys to the matching build-side tuples */
+  FlatHashTable<KeyT, std::vector<Tuple>> ht_{};
 };
 
 /**
@@ -152,15 +226,55 @@ class HashJoinExecutor : public AbstractExecutor {
   }
 
  private:
+  /**
+   * Refill the probe batch: pull up to PROBE_BATCH_SIZE probe-side tuples, hash their join keys
+   * in one pass, and resolve each key's match list with the table slot prefetched ahead of use.
+   * @return `true` if at least one probe tuple was pulled
+   */
+  auto ProbeBatch() -> bool;
+
+  /** Number of build-side tuples pulled and keyed per batch during Init() */
+  static constexpr size_t BATCH_SIZE = 1024;
+  /** Number of probe-side tuples hashed and looked up per ProbeBatch() pass */
+  static constexpr size_t PROBE_BATCH_SIZE = 256;
+  /** Look up the match list this many probes behind the prefetch, enough to cover a DRAM miss */
+  static constexpr size_t PROBE_PREFETCH_DISTANCE = 16;
+
   /** The NestedLoopJoin plan node to be executed. */
   const HashJoinPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> left_child_executor_{nullptr};
   std::unique_ptr<AbstractExecutor> right_child_executor_{nullptr};
-  SimpleJoinHashTable right_ht_;
+  /** Build-side tables; exactly one is populated per Init, picked by fixed_keys_ */
+  SimpleJoinHashTable<JoinKey> right_ht_;
+  SimpleJoinHashTable<FixedJoinKey> right_fixed_ht_;
+  /** True when every key column on both sides is a fixed-width integer (decided once in Init
+   * from the expression return types), so keys use the compact FixedJoinKey representation */
+  bool fixed_keys_{false};
+  /** The build-side matches for the current left tuple, probed once per left tuple; continuing
+   * calls replay from last_index_ without re-hashing the key (stable: the build side is frozen
+   * after Init) */
+  const std::vector<Tuple> *current_matches_{nullptr};
   int last_index_{0};
   bool start_from_new_one_{true};
   bool has_matched_{false};
   Tuple last_left_tuple_;
+  /** Probe-side key expressions resolved to column indexes in Init() (-1 = general expression);
+   * bare column references skip the virtual Evaluate per probe */
+  std::vector<int> left_key_cols_;
+  /** The current probe batch and the match list resolved for each of its tuples; probe_pos_ is
+   * the next unconsumed entry */
+  std::vector<Tuple> probe_batch_;
+  std::vector<const std::vector<Tuple> *> probe_matches_;
+  size_t probe_pos_{0};
+  /** Reused per-batch scratch for the probe keys (one of the two, matching fixed_keys_) and
+   * their hashes */
+  std::vector<JoinKey> probe_keys_;
+  std::vector<FixedJoinKey> probe_fixed_keys_;
+  std::vector<size_t> probe_hashes_;
+  /** The inferred join output schema, computed once at construction instead of per output row */
+  Schema output_schema_cached_;
+  /** Reused output-row buffer so Next() does not allocate a fresh vector per emitted tuple */
+  std::vector<Value> values_scratch_;
 };
 
 }  // namespace bustub
@@ -12,7 +12,10 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "common/rid.h"
@@ -46,7 +49,15 @@ class IndexScanExecutor : public AbstractExecutor {
  private:
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
-  std::shared_ptr<BPlusTreeIndexIteratorForTwoIntegerColumn> itor_;
+  /** Stored in place: the iterator is advanced on every Next(), so it must not sit behind a
+   * refcounted indirection. */
+  std::optional<BPlusTreeIndexIteratorForTwoIntegerColumn> itor_;
   TableInfo *table_info_;
+  /** Local refill buffer for NextBatch: one iterator call drains up to a page's worth of
+   * entries, so the leaf latch and pin are touched once per batch instead of once per tuple. */
+  static constexpr int kBatchSize = 64;
+  std::array<std::pair<IntegerKeyType, IntegerValueType>, kBatchSize> batch_;
+  int batch_size_{0};
+  int batch_pos_{0};
 };
 }  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -59,6 +60,18 @@ class InsertExecutor : public AbstractExecutor {
   const InsertPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
   bool is_visited_{false};
+  /** Indexes sharing identical key attributes; their key is projected once per tuple */
+  struct IndexKeyGroup {
+    std::vector<uint32_t> key_attrs_;
+    const Schema *key_schema_;
+    std::vector<IndexInfo *> indexes_;
+  };
+
+  /** Catalog entries resolved once in Init(); the per-tuple loop must not re-probe the catalog */
+  TableInfo *table_info_{nullptr};
+  std::vector<IndexKeyGroup> key_groups_;
+  /** Reused output-row buffer so Next() does not allocate a fresh vector per emitted tuple */
+  std::vector<Value> values_scratch_;
 };
 
 }  // namespace bustub
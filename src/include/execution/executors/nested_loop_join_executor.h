@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -53,6 +54,15 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
+  /** Next() specialised per join type, selected once in the constructor: the hot loop then
+   * carries no per-iteration JoinType compare and the LEFT-only match bookkeeping folds away
+   * for inner joins. */
+  template <JoinType JT>
+  auto NextImpl(Tuple *tuple, RID *rid) -> bool;
+
+  using NextFn = auto (NestedLoopJoinExecutor::*)(Tuple *, RID *) -> bool;
+  NextFn next_fn_;
+
   /** The NestedLoopJoin plan node to be executed. */
   const NestedLoopJoinPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> left_child_executor_;
@@ -60,6 +70,19 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
   bool start_from_new_one_{true};
   bool has_matched_{false};
   Tuple last_left_tuple_;
+  /** The right side materialized once in Init(); rewinding per left tuple is an index reset
+   * instead of re-running the right subtree */
+  std::vector<Tuple> right_tuples_;
+  size_t right_index_{0};
+  /** Blocked Bloom filter over the right-side keys of one equi-join conjunct, built in Init()
+   * for inner joins; left tuples whose key cannot appear on the right skip the right-side scan
+   * entirely. -1 = predicate not AND-decomposable into a column equality, filter disabled. */
+  int bloom_left_col_{-1};
+  std::vector<uint64_t> bloom_bits_;
+  /** The inferred join output schema, computed once at construction instead of per output row */
+  Schema output_schema_cached_;
+  /** Reused output-row buffer so Next() does not allocate a fresh vector per emitted tuple */
+  std::vector<Value> values_scratch_;
 };
 
 }  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "execution/executor_context.h"
@@ -47,6 +48,11 @@ class ProjectionExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /** @return The child's row estimate; a projection emits exactly one tuple per input tuple */
+  auto EstimatedCardinality() const -> std::optional<size_t> override {
+    return child_executor_->EstimatedCardinality();
+  }
+
   /** @return The output schema for the projection plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -46,12 +47,34 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield up to `max` tuples from the sequential scan in one call.
+   * @param[out] tuples Cleared, then filled with the produced tuples
+   * @param max The maximum number of tuples to produce
+   * @return `true` if at least one tuple was produced
+   */
+  auto NextBatch(std::vector<Tuple> *tuples, size_t max) -> bool override;
+
+  /** @return The table's insert count as an upper-bound row estimate (available after Init) */
+  auto EstimatedCardinality() const -> std::optional<size_t> override {
+    if (table_info_ == nullptr) {
+      return std::nullopt;
+    }
+    return table_info_->table_->GetInsertCount();
+  }
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
-  std::shared_ptr<TableIterator> itor_{nullptr};
+  /** Stored in place: the iterator is advanced on every Next(), so it must not sit behind a
+   * refcounted indirection. */
+  std::optional<TableIterator> itor_;
+  /** Resolved once in Init(); the per-row loop must not re-probe the catalog or the context */
+  TableInfo *table_info_{nullptr};
+  Transaction *txn_{nullptr};
+  IsolationLevel iso_level_{IsolationLevel::REPEATABLE_READ};
 };
 }  // namespace bustub
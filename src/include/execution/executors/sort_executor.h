@@ -50,10 +50,28 @@ class SortExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** Number of tuples pulled from the child per NextBatch() call */
+  static constexpr size_t BATCH_SIZE = 1024;
+
+  /** One sortable row: where its precomputed order-by keys start in the key pool and the offset
+   * of the serialized tuple in the arena. Plain indices rather than a per-entry vector, so the
+   * entries are trivially destructible and re-Init never frees per-row storage. */
+  struct SortEntry {
+    uint32_t key_first_;
+    uint32_t offset_;
+  };
+
   /** The sort plan node to be executed */
   const SortPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_{nullptr};
-  std::vector<Tuple> vals_;
+  /** Tuple payloads appended end to end in one buffer: one bump of the arena per input row
+   * instead of a heap-owned byte vector per tuple, and Init() frees it all at once */
+  std::vector<char> arena_;
+  std::vector<SortEntry> entries_;
+  /** All rows' order-by keys appended end to end (order_bys.size() per row), indexed by
+   * SortEntry::key_first_. One flat buffer whose capacity survives re-Init, instead of one
+   * heap-allocated vector per row rebuilt every invocation. */
+  std::vector<Value> key_pool_;
   size_t index_{0};
 };
 }  // namespace bustub
@@ -59,6 +59,9 @@ class TopNExecutor : public AbstractExecutor {
   auto GetNumInHeap() -> size_t;
 
  private:
+  /** Number of tuples pulled from the child per NextBatch() call */
+  static constexpr size_t BATCH_SIZE = 1024;
+
   /** The topn plan node to be executed */
   const TopNPlanNode *plan_;
   /** The child executor from which tuples are obtained */
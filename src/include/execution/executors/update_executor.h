@@ -65,5 +65,18 @@ class UpdateExecutor : public AbstractExecutor {
   /** The child executor to obtain value from */
   std::unique_ptr<AbstractExecutor> child_executor_;
   bool is_visited_{false};
+  /** Indexes sharing identical key attributes; their key is projected once per tuple. touched_
+   * records whether any target expression rewrites a key column (decided once in Init): an
+   * untouched key keeps its value across the update, so the new-tuple projection is skipped. */
+  struct IndexKeyGroup {
+    std::vector<uint32_t> key_attrs_;
+    const Schema *key_schema_;
+    std::vector<IndexInfo *> indexes_;
+    bool touched_;
+  };
+
+  std::vector<IndexKeyGroup> key_groups_;
+  /** Reused output-row buffer so Next() does not allocate a fresh vector per emitted tuple */
+  std::vector<Value> values_scratch_;
 };
 }  // namespace bustub
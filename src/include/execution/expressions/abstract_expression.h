@@ -34,6 +34,10 @@ namespace bustub {
 class AbstractExpression;
 using AbstractExpressionRef = std::shared_ptr<AbstractExpression>;
 
+/** A discriminated tag for the concrete expression types, stored in the base class so callers
+ * can test a node's type with one byte compare instead of an RTTI-walking dynamic_cast. */
+enum class ExprKind : uint8_t { Invalid, Arithmetic, ColumnValue, Comparison, ConstantValue, Logic, String };
+
 /**
  * AbstractExpression is the base class of all the expressions in the system.
  * Expressions are modeled as trees, i.e. every expression may have a variable number of children.
@@ -44,9 +48,11 @@ class AbstractExpression {
    * Create a new AbstractExpression with the given children and return type.
    * @param children the children of this abstract expression
    * @param ret_type the return type of this abstract expression when it is evaluated
+   * @param kind the concrete type tag of this expression; see ExprKind
    */
-  AbstractExpression(std::vector<AbstractExpressionRef> children, TypeId ret_type)
-      : children_{std::move(children)}, ret_type_{ret_type} {}
+  AbstractExpression(std::vector<AbstractExpressionRef> children, TypeId ret_type,
+                     ExprKind kind = ExprKind::Invalid)
+      : children_{std::move(children)}, ret_type_{ret_type}, kind_{kind} {}
 
   /** Virtual destructor. */
   virtual ~AbstractExpression() = default;
@@ -74,6 +80,9 @@ class AbstractExpression {
   /** @return the type of this expression if it were to be evaluated */
   virtual auto GetReturnType() const -> TypeId { return ret_type_; }
 
+  /** @return the concrete type tag of this expression */
+  auto GetKind() const -> ExprKind { return kind_; }
+
   /** @return the string representation of the plan node and its children */
   virtual auto ToString() const -> std::string { return "<unknown>"; }
 
@@ -87,8 +96,19 @@ class AbstractExpression {
  private:
   /** The return type of this expression. */
   TypeId ret_type_;
+  /** The concrete type tag, set once by the subclass constructor. */
+  ExprKind kind_;
 };
 
+/**
+ * Tag-checked counterpart of dynamic_cast for expression nodes: one stored-kind compare plus a
+ * static_cast instead of an RTTI walk. T must declare its matching tag as `static KIND`.
+ */
+template <typename T>
+auto ExprCast(const AbstractExpression *expr) -> const T * {
+  return expr != nullptr && expr->GetKind() == T::KIND ? static_cast<const T *>(expr) : nullptr;
+}
+
 }  // namespace bustub
 
 template <typename T>
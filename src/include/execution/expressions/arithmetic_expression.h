@@ -36,9 +36,12 @@ enum class ArithmeticType { Plus, Minus };
  */
 class ArithmeticExpression : public AbstractExpression {
  public:
+  /** The ExprKind tag identifying this expression type; see ExprCast. */
+  static constexpr ExprKind KIND = ExprKind::Arithmetic;
+
   /** Creates a new comparison expression representing (left comp_type right). */
   ArithmeticExpression(AbstractExpressionRef left, AbstractExpressionRef right, ArithmeticType compute_type)
-      : AbstractExpression({std::move(left), std::move(right)}, TypeId::INTEGER), compute_type_{compute_type} {
+      : AbstractExpression({std::move(left), std::move(right)}, TypeId::INTEGER, KIND), compute_type_{compute_type} {
     if (GetChildAt(0)->GetReturnType() != TypeId::INTEGER || GetChildAt(1)->GetReturnType() != TypeId::INTEGER) {
       throw bustub::NotImplementedException("only support integer for now");
     }
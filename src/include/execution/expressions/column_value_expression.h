@@ -26,6 +26,9 @@ namespace bustub {
  */
 class ColumnValueExpression : public AbstractExpression {
  public:
+  /** The ExprKind tag identifying this expression type; see ExprCast. */
+  static constexpr ExprKind KIND = ExprKind::ColumnValue;
+
   /**
    * ColumnValueExpression is an abstraction around "Table.member" in terms of indexes.
    * @param tuple_idx {tuple index 0 = left side of join, tuple index 1 = right side of join}
@@ -33,7 +36,7 @@ class ColumnValueExpression : public AbstractExpression {
    * @param ret_type the return type of the expression
    */
   ColumnValueExpression(uint32_t tuple_idx, uint32_t col_idx, TypeId ret_type)
-      : AbstractExpression({}, ret_type), tuple_idx_{tuple_idx}, col_idx_{col_idx} {}
+      : AbstractExpression({}, ret_type, KIND), tuple_idx_{tuple_idx}, col_idx_{col_idx} {}
 
   auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
     return tuple->GetValue(&schema, col_idx_);
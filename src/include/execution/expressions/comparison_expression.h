@@ -32,9 +32,12 @@ enum class ComparisonType { Equal, NotEqual, LessThan, LessThanOrEqual, GreaterT
  */
 class ComparisonExpression : public AbstractExpression {
  public:
+  /** The ExprKind tag identifying this expression type; see ExprCast. */
+  static constexpr ExprKind KIND = ExprKind::Comparison;
+
   /** Creates a new comparison expression representing (left comp_type right). */
   ComparisonExpression(AbstractExpressionRef left, AbstractExpressionRef right, ComparisonType comp_type)
-      : AbstractExpression({std::move(left), std::move(right)}, TypeId::BOOLEAN), comp_type_{comp_type} {}
+      : AbstractExpression({std::move(left), std::move(right)}, TypeId::BOOLEAN, KIND), comp_type_{comp_type} {}
 
   auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
     Value lhs = GetChildAt(0)->Evaluate(tuple, schema);
@@ -24,8 +24,11 @@ namespace bustub {
  */
 class ConstantValueExpression : public AbstractExpression {
  public:
+  /** The ExprKind tag identifying this expression type; see ExprCast. */
+  static constexpr ExprKind KIND = ExprKind::ConstantValue;
+
   /** Creates a new constant value expression wrapping the given value. */
-  explicit ConstantValueExpression(const Value &val) : AbstractExpression({}, val.GetTypeId()), val_(val) {}
+  explicit ConstantValueExpression(const Value &val) : AbstractExpression({}, val.GetTypeId(), KIND), val_(val) {}
 
   auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override { return val_; }
 
@@ -36,9 +36,12 @@ enum class LogicType { And, Or };
  */
 class LogicExpression : public AbstractExpression {
  public:
+  /** The ExprKind tag identifying this expression type; see ExprCast. */
+  static constexpr ExprKind KIND = ExprKind::Logic;
+
   /** Creates a new comparison expression representing (left comp_type right). */
   LogicExpression(AbstractExpressionRef left, AbstractExpressionRef right, LogicType logic_type)
-      : AbstractExpression({std::move(left), std::move(right)}, TypeId::BOOLEAN), logic_type_{logic_type} {
+      : AbstractExpression({std::move(left), std::move(right)}, TypeId::BOOLEAN, KIND), logic_type_{logic_type} {
     if (GetChildAt(0)->GetReturnType() != TypeId::BOOLEAN || GetChildAt(1)->GetReturnType() != TypeId::BOOLEAN) {
       throw bustub::NotImplementedException("expect boolean from either side");
     }
@@ -37,8 +37,11 @@ enum class StringExpressionType { Lower, Upper };
  */
 class StringExpression : public AbstractExpression {
  public:
+  /** The ExprKind tag identifying this expression type; see ExprCast. */
+  static constexpr ExprKind KIND = ExprKind::String;
+
   StringExpression(AbstractExpressionRef arg, StringExpressionType expr_type)
-      : AbstractExpression({std::move(arg)}, TypeId::VARCHAR), expr_type_{expr_type} {
+      : AbstractExpression({std::move(arg)}, TypeId::VARCHAR, KIND), expr_type_{expr_type} {
     if (GetChildAt(0)->GetReturnType() != TypeId::VARCHAR) {
       throw bustub::NotImplementedException("expect the first arg to be varchar");
     }
@@ -17,6 +17,7 @@
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 
@@ -58,6 +59,15 @@ class DiskManager {
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Write a run of pages with consecutive page ids to the database file as one combined I/O:
+   * a single seek, one sequential write per buffer and a single flush, instead of a
+   * seek-write-flush cycle per page.
+   * @param start_page_id id of the first page in the run
+   * @param pages raw page data, one buffer per consecutive page id
+   */
+  virtual void WritePages(page_id_t start_page_id, const std::vector<const char *> &pages);
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
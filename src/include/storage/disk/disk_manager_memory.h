@@ -53,6 +53,13 @@ class DiskManagerMemory : public DiskManager {
    */
   void ReadPage(page_id_t page_id, char *page_data) override;
 
+  /** The base class combines writes on its file stream; in-memory storage just writes page-wise. */
+  void WritePages(page_id_t start_page_id, const std::vector<const char *> &pages) override {
+    for (size_t i = 0; i < pages.size(); ++i) {
+      WritePage(start_page_id + static_cast<page_id_t>(i), pages[i]);
+    }
+  }
+
  private:
   char *memory_;
 };
@@ -115,6 +122,13 @@ class DiskManagerUnlimitedMemory : public DiskManager {
     memcpy(page_data, ptr->first.data(), BUSTUB_PAGE_SIZE);
   }
 
+  /** The base class combines writes on its file stream; in-memory storage just writes page-wise. */
+  void WritePages(page_id_t start_page_id, const std::vector<const char *> &pages) override {
+    for (size_t i = 0; i < pages.size(); ++i) {
+      WritePage(start_page_id + static_cast<page_id_t>(i), pages[i]);
+    }
+  }
+
   void SetLatency(size_t latency_ms) { latency_ = latency_ms; }
 
  private:
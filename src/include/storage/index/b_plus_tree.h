@@ -11,6 +11,8 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <deque>
 #include <iostream>
 #include <optional>
@@ -21,6 +23,7 @@
 
 #include "common/config.h"
 #include "common/macros.h"
+#include "fmt/format.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_header_page.h"
@@ -32,6 +35,41 @@ namespace bustub {
 
 struct PrintableBPlusTree;
 
+/**
+ * @brief Fixed-capacity ring of write guards backing Context::write_set_.
+ *
+ * The latch chain is bounded by the tree depth, so a small inline array replaces std::deque's
+ * chunked heap allocations on the hot insert/remove path. Capacity 32 covers any reachable depth
+ * (fanout of at least 2 per level). Mirrors the deque member API used by the tree code.
+ */
+class WriteGuardRing {
+ public:
+  auto empty() const -> bool { return count_ == 0; }
+  auto size() const -> size_t { return count_; }
+  auto front() -> WritePageGuard & { return slots_[head_]; }
+  auto back() -> WritePageGuard & { return slots_[(head_ + count_ - 1) % kCapacity]; }
+  void push_back(WritePageGuard &&guard) {
+    BUSTUB_ASSERT(count_ < kCapacity, "b+tree write set deeper than ring capacity");
+    slots_[(head_ + count_) % kCapacity] = std::move(guard);
+    count_++;
+  }
+  void pop_back() {
+    slots_[(head_ + count_ - 1) % kCapacity] = WritePageGuard{};
+    count_--;
+  }
+  void pop_front() {
+    slots_[head_] = WritePageGuard{};
+    head_ = (head_ + 1) % kCapacity;
+    count_--;
+  }
+
+ private:
+  static constexpr size_t kCapacity = 32;
+  std::array<WritePageGuard, kCapacity> slots_;
+  size_t head_{0};
+  size_t count_{0};
+};
+
 /**
  * @brief Definition of the Context class.
  *
@@ -48,7 +86,7 @@ class Context {
   page_id_t root_page_id_{INVALID_PAGE_ID};
 
   // Store the write guards of the pages that you're modifying here.
-  std::deque<WritePageGuard> write_set_;
+  WriteGuardRing write_set_;
 
   // You may want to use this when getting value, but not necessary.
   std::deque<ReadPageGuard> read_set_;
@@ -118,13 +156,34 @@ class BPlusTree {
 
  private:
   /* Debug Routines for FREE!! */
-  void ToGraph(page_id_t page_id, const BPlusTreePage *page, std::ofstream &out);
+  void ToGraph(page_id_t page_id, const BPlusTreePage *page, fmt::memory_buffer &buf);
 
   void PrintTree(page_id_t page_id, const BPlusTreePage *page);
 
-  void DoSplit(Context &ctx);
+  /** Pessimistic descents, split out of Insert/Remove so the optimistic fast paths stay compact
+   * in the instruction cache. Only taken when the leaf may split or merge. */
+  auto InsertSlow(const KeyType &key, const ValueType &value, page_id_t start_page_id) -> bool;
+
+  void RemoveSlow(const KeyType &key, page_id_t start_page_id);
+
+  void DoSplit(Context &ctx, BPlusTreePage *page, int size);
+
+  void DoMerge(Context &ctx, BPlusTreePage *page, int size);
+
+  /** @return the first leaf slot whose key is >= `key` (GetSize() if none): the exact-match
+   * candidate and the insert position. Branch-free binary search with in-page prefetch. */
+  auto FindLeafSlot(const LeafPage *leaf_page, const KeyType &key, bool *found) const -> int;
+
+  /** @return the child slot to descend into for `key`: the number of separator keys < `key`. */
+  auto FindChildSlot(const InternalPage *internal_page, const KeyType &key) const -> int;
+
+  /** @return the slot where a new separator for `key` belongs: one past the separators <= `key`. */
+  auto FindSeparatorSlot(const InternalPage *internal_page, const KeyType &key) const -> int;
 
-  void DoMerge(Context &ctx);
+  /** Walk the internal levels from `start_page_id` down to the leaf that may contain `key`,
+   * holding one read latch at a time. On success `*leaf_guard` owns the latched leaf and the
+   * typed pointer into it is returned; nullptr means the descent hit an invalid or empty page. */
+  auto DescendToLeaf(const KeyType &key, page_id_t start_page_id, ReadPageGuard *leaf_guard) -> const LeafPage *;
 
   /**
    * @brief Convert A B+ tree into a Printable B+ tree
@@ -142,6 +201,20 @@ class BPlusTree {
   int leaf_max_size_;
   int internal_max_size_;
   page_id_t header_page_id_;
+  /** One-shot cache of the root page id. The header is written exactly once, when the first
+   * insert creates the root; splits and merges reuse the root page in place (see DoSplit), so
+   * once this is set every operation can descend from it without latching the header page. */
+  std::atomic<page_id_t> cached_root_page_id_{INVALID_PAGE_ID};
+  /** Hint for append-heavy streams: the page id of the rightmost leaf, refreshed whenever an
+   * insert write-latches a leaf with no next page and invalidated when a leaf merge orphans a
+   * page. Insert re-validates it under the leaf's write latch (still cached, still a leaf,
+   * still rightmost, key above its last entry), so a stale hint only costs the normal descent. */
+  std::atomic<page_id_t> rightmost_leaf_{INVALID_PAGE_ID};
+  /** Number of keys in the tree, maintained by Insert/Remove. Approximate only while a
+   * concurrent writer is mid-operation, which matches the old fetch-the-root semantics: the
+   * answer could be stale the moment the call returned anyway. Lets IsEmpty() answer with one
+   * atomic load instead of latching the header page and then the root page. */
+  std::atomic<int64_t> approx_size_{0};
 };
 
 /**
@@ -77,6 +77,26 @@ template <size_t KeySize>
 class GenericComparator {
  public:
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    // Single-integer key schemas: compare the raw bytes as one signed integer of the column's
+    // width instead of deserializing both sides into Value objects. This is the comparator the
+    // index binary searches hammer on every probe; memcpy keeps the loads well-defined and
+    // compiles down to a single fixed-width compare. A raw memcmp over the whole key would be
+    // wrong here -- the blob stores little-endian signed integers, whose byte order does not
+    // match their value order -- so the dispatch stays typed.
+    if (fast_compare_ == FastCompare::kInt64) {
+      int64_t x;
+      int64_t y;
+      memcpy(&x, lhs.data_, sizeof(x));
+      memcpy(&y, rhs.data_, sizeof(y));
+      return static_cast<int>(x > y) - static_cast<int>(x < y);
+    }
+    if (fast_compare_ == FastCompare::kInt32) {
+      int32_t x;
+      int32_t y;
+      memcpy(&x, lhs.data_, sizeof(x));
+      memcpy(&y, rhs.data_, sizeof(y));
+      return static_cast<int>(x > y) - static_cast<int>(x < y);
+    }
     uint32_t column_count = key_schema_->GetColumnCount();
 
     for (uint32_t i = 0; i < column_count; i++) {
@@ -94,13 +114,28 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_}, fast_compare_{other.fast_compare_} {}
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {
+    if (key_schema->GetColumnCount() == 1 && key_schema->GetColumn(0).GetOffset() == 0) {
+      const auto type = key_schema->GetColumn(0).GetType();
+      if (type == TypeId::BIGINT && KeySize >= sizeof(int64_t)) {
+        fast_compare_ = FastCompare::kInt64;
+      } else if (type == TypeId::INTEGER && KeySize >= sizeof(int32_t)) {
+        fast_compare_ = FastCompare::kInt32;
+      }
+    }
+  }
 
  private:
+  /** Fixed-width compare to use when the schema is a single inline integer column at offset 0,
+   * decided once at index build. */
+  enum class FastCompare : uint8_t { kNone, kInt32, kInt64 };
+
   Schema *key_schema_;
+  FastCompare fast_compare_{FastCompare::kNone};
 };
 
 }  // namespace bustub
@@ -33,28 +33,36 @@ class IndexIterator {
 
   auto operator++() -> IndexIterator &;
 
+  /** Copy up to `cap` mappings into `out` and advance past them, hopping to the next leaf when
+   * this one is drained. Amortizes the latch/pin traffic of per-tuple advances over a whole
+   * page's worth of entries. @return the number of mappings written; 0 at the end of the scan. */
+  auto NextBatch(MappingType *out, int cap) -> int;
+
+  // End iterators (negative index) compare equal regardless of which page they drained; live
+  // iterators must agree on both the slot and the page. One fused predicate, no early returns.
   auto operator==(const IndexIterator &itr) const -> bool {
-    if (index_ != itr.index_) {
-      return false;
-    }
-    if (index_ < 0) {
-      return true;
-    }
-    return guard_.GetData() == itr.guard_.GetData();
+    return index_ == itr.index_ && (index_ < 0 || leaf_ == itr.leaf_);
   }
 
-  auto operator!=(const IndexIterator &itr) const -> bool {
-    if (index_ == itr.index_ && index_ < 0) {
-      return false;
-    }
-    return index_ != itr.index_ || guard_.GetData() != itr.guard_.GetData();
-  }
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
+  /** Slow path shared by operator++ and NextBatch: follow the next-page link and re-establish
+   * the cached-leaf invariant, or enter the end state when there is no next leaf. */
+  void AdvancePage();
+
   // add your own private member variables here
   BufferPoolManager *bpm_{nullptr};
   mutable ReadPageGuard guard_{};
   int index_{0};
+  // Invariant maintained by the constructor and operator++: either index_ < 0 (end) or
+  // leaf_ points at the page held by guard_ and 0 <= index_ < size_. Caching the typed
+  // pointer and size here keeps the per-tuple path free of re-derivation and null checks.
+  const B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_{nullptr};
+  int size_{0};
+  // The leaf stores keys and values in separate arrays, so operator* materializes the pair here
+  // to keep returning a reference.
+  MappingType current_{};
 };
 
 }  // namespace bustub
@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <algorithm>
 #include <queue>
 #include <string>
 
@@ -19,7 +20,7 @@ namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
 #define INTERNAL_PAGE_HEADER_SIZE 12
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(KeyType) + sizeof(ValueType)))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -28,9 +29,11 @@ namespace bustub {
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
- * Internal page format (keys are stored in increasing order):
+ * Internal page format (keys are stored in increasing order, in an array
+ * separate from the child page ids so that binary search touches only
+ * key-bearing cache lines):
  *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
+ * | HEADER | KEY(1) | ... | KEY(n) | PAGE_ID(1) | ... | PAGE_ID(n) |
  *  --------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
@@ -77,8 +80,26 @@ class BPlusTreeInternalPage : public BPlusTreePage {
 
   void RemoveAt(int index);
 
-  auto MappingAt(int index) const -> const MappingType & { return array_[index]; }
-  void SetMappingAt(int index, const MappingType &pair) { array_[index] = pair; }
+  /** Address of the key slot, for prefetching upcoming binary-search probes. */
+  auto KeyPtrAt(int index) const -> const KeyType * { return &keys_[index]; }
+  void SetMappingAt(int index, const MappingType &pair) {
+    keys_[index] = pair.first;
+    values_[index] = pair.second;
+  }
+
+  /** Copy `count` consecutive mappings from `src` starting at `src_first` into this page
+   * starting at `first`. Two bulk copies (one per parallel array) the compiler lowers to
+   * memmove-style block moves instead of a per-slot SetMappingAt loop; the ranges may overlap
+   * when shifting within a page, so the direction picks the overlap-safe variant. */
+  void CopyMappings(int first, const BPlusTreeInternalPage *src, int src_first, int count) {
+    if (src != this || first <= src_first) {
+      std::copy(&src->keys_[src_first], &src->keys_[src_first + count], &keys_[first]);
+      std::copy(&src->values_[src_first], &src->values_[src_first + count], &values_[first]);
+    } else {
+      std::copy_backward(&src->keys_[src_first], &src->keys_[src_first + count], &keys_[first + count]);
+      std::copy_backward(&src->values_[src_first], &src->values_[src_first + count], &values_[first + count]);
+    }
+  }
 
   /**
    * @brief For test only, return a string representing all keys in
@@ -107,7 +128,11 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   }
 
  private:
-  // Flexible array member for page data.
-  MappingType array_[0];
+  // Parallel arrays (structure-of-arrays): the search loop streams through keys_ without pulling
+  // the interleaved child page ids into cache; values_ is touched once to pick the child.
+  // keys_[0] is logically undefined -- separators live at [1, size) -- and must never be read;
+  // nothing zeroes it either, since that would be a dead store that still dirties the frame.
+  KeyType keys_[INTERNAL_PAGE_SIZE];
+  ValueType values_[INTERNAL_PAGE_SIZE];
 };
 }  // namespace bustub
@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
@@ -20,16 +21,17 @@ namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
 #define LEAF_PAGE_HEADER_SIZE 16
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (sizeof(KeyType) + sizeof(ValueType)))
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
  * page. Only support unique key.
  *
- * Leaf page format (keys are stored in order):
+ * Leaf page format (keys are stored in order, in an array separate from the
+ * values so that binary search touches only key-bearing cache lines):
  *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
+ * | HEADER | KEY(1) | KEY(2) | ... | KEY(n) | RID(1) | RID(2) | ... | RID(n)
  *  ----------------------------------------------------------------------
  *
  *  Header format (size in byte, 16 bytes in total):
@@ -59,8 +61,26 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   void SetNextPageId(page_id_t next_page_id);
   auto KeyAt(int index) const -> KeyType;
   auto ValueAt(int index) const -> ValueType;
-  auto MappingAt(int index) const -> const MappingType & { return array_[index]; }
-  void SetMappingAt(int index, const MappingType &pair) { array_[index] = pair; }
+  /** Address of the key slot, for prefetching upcoming binary-search probes. */
+  auto KeyPtrAt(int index) const -> const KeyType * { return &keys_[index]; }
+  void SetMappingAt(int index, const MappingType &pair) {
+    keys_[index] = pair.first;
+    values_[index] = pair.second;
+  }
+
+  /** Copy `count` consecutive mappings from `src` starting at `src_first` into this page
+   * starting at `first`. Two bulk copies (one per parallel array) the compiler lowers to
+   * memmove-style block moves instead of a per-slot SetMappingAt loop; the ranges may overlap
+   * when shifting within a page, so the direction picks the overlap-safe variant. */
+  void CopyMappings(int first, const BPlusTreeLeafPage *src, int src_first, int count) {
+    if (src != this || first <= src_first) {
+      std::copy(&src->keys_[src_first], &src->keys_[src_first + count], &keys_[first]);
+      std::copy(&src->values_[src_first], &src->values_[src_first + count], &values_[first]);
+    } else {
+      std::copy_backward(&src->keys_[src_first], &src->keys_[src_first + count], &keys_[first + count]);
+      std::copy_backward(&src->values_[src_first], &src->values_[src_first + count], &values_[first + count]);
+    }
+  }
   void InsertAt(int index, const MappingType &pair);
   void RemoveAt(int index);
 
@@ -91,7 +111,9 @@ class BPlusTreeLeafPage : public BPlusTreePage {
 
  private:
   page_id_t next_page_id_;
-  // Flexible array member for page data.
-  MappingType array_[0];
+  // Parallel arrays (structure-of-arrays): the search loop streams through keys_ without pulling
+  // the interleaved values into cache; values_ is touched once at the end of a lookup.
+  KeyType keys_[LEAF_PAGE_SIZE];
+  ValueType values_[LEAF_PAGE_SIZE];
 };
 }  // namespace bustub
@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <new>
 
 #include "common/config.h"
 #include "common/rwlatch.h"
@@ -24,20 +26,26 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The class is cacheline-aligned so that the hot header (page id, pin count, dirty flag) and the content latch of
+ * one buffer frame never share a cacheline with the neighboring frame in the pages_ array; latching or pinning one
+ * page then cannot ping-pong the header of an unrelated one.
  */
-class Page {
+class alignas(64) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
   friend class BufferPoolManager;
 
  public:
   /** Constructor. Zeros out the page data. */
   Page() {
-    data_ = new char[BUSTUB_PAGE_SIZE];
+    // Align the data buffer to the page size so it can be handed to direct I/O without bounce
+    // buffers and never straddles more pages of virtual memory than it has to.
+    data_ = static_cast<char *>(::operator new[](BUSTUB_PAGE_SIZE, std::align_val_t(BUSTUB_PAGE_SIZE)));
     ResetMemory();
   }
 
   /** Default destructor. */
-  ~Page() { delete[] data_; }
+  ~Page() { ::operator delete[](data_, std::align_val_t(BUSTUB_PAGE_SIZE)); }
 
   /** @return the actual data contained within this page */
   inline auto GetData() -> char * { return data_; }
@@ -87,12 +95,16 @@ class Page {
   char *data_;
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  /** The pin count of this page. Atomic so UnpinPage can decrement it without a latch. */
+  std::atomic<int> pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
-  /** Page latch. */
-  ReaderWriterLatch rwlatch_;
+  std::atomic<bool> is_dirty_ = false;
+  /**
+   * Page latch. Placed on its own cacheline: the buffer pool manager's hot metadata (data pointer,
+   * page id, pin count, dirty flag) fills the first line of the object, so reader/writer latch
+   * traffic does not invalidate the line that pin and unpin operate on.
+   */
+  alignas(64) ReaderWriterLatch rwlatch_;
 };
 
 }  // namespace bustub
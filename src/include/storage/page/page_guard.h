@@ -10,7 +10,7 @@ class BasicPageGuard {
  public:
   BasicPageGuard() = default;
 
-  BasicPageGuard(BufferPoolManager *bpm, Page *page) : bpm_(bpm), page_(page) {}
+  BasicPageGuard(BufferPoolManager *bpm, Page *page) : bpm_(bpm), tagged_page_(reinterpret_cast<uintptr_t>(page)) {}
 
   BasicPageGuard(const BasicPageGuard &) = delete;
   auto operator=(const BasicPageGuard &) -> BasicPageGuard & = delete;
@@ -59,9 +59,15 @@ class BasicPageGuard {
    */
   ~BasicPageGuard();
 
-  auto PageId() -> page_id_t { return page_->GetPageId(); }
+  auto PageId() -> page_id_t { return PagePtr()->GetPageId(); }
 
-  auto GetData() -> const char * { return page_->GetData(); }
+  /** @return the page data, or nullptr for an empty guard (failed fetch or moved-from). Callers
+   * null-test the As()/AsMut() result, so an empty guard must report itself instead of faulting
+   * before that test can run. */
+  auto GetData() -> const char * {
+    auto page = PagePtr();
+    return page != nullptr ? page->GetData() : nullptr;
+  }
 
   template <class T>
   auto As() -> const T * {
@@ -69,8 +75,12 @@ class BasicPageGuard {
   }
 
   auto GetDataMut() -> char * {
-    is_dirty_ = true;
-    return page_->GetData();
+    auto page = PagePtr();
+    if (page == nullptr) {
+      return nullptr;
+    }
+    tagged_page_ |= kDirtyBit;
+    return page->GetData();
   }
 
   template <class T>
@@ -81,20 +91,26 @@ class BasicPageGuard {
  private:
   void Steal(BasicPageGuard &that) {
     bpm_ = that.bpm_;
-    page_ = that.page_;
-    is_dirty_ = that.is_dirty_;
+    tagged_page_ = that.tagged_page_;
     that.bpm_ = nullptr;
-    that.page_ = nullptr;
-    that.is_dirty_ = false;
+    that.tagged_page_ = 0;
   }
 
+  /** The guarded page, stripped of the dirty tag. */
+  auto PagePtr() const -> Page * { return reinterpret_cast<Page *>(tagged_page_ & ~kDirtyBit); }
+
+  auto IsDirty() const -> bool { return (tagged_page_ & kDirtyBit) != 0; }
+
  private:
   friend class ReadPageGuard;
   friend class WritePageGuard;
 
+  /** Pages are word-aligned, so the dirty flag rides in bit 0 of the page pointer: a guard is
+   * two machine words, moves are two stores, and Drop resets a single field. */
+  static constexpr uintptr_t kDirtyBit = 1;
+
   BufferPoolManager *bpm_{nullptr};
-  Page *page_{nullptr};
-  bool is_dirty_{false};
+  uintptr_t tagged_page_{0};
 };
 
 class ReadPageGuard {
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>  // NOLINT
 #include <optional>
 #include <utility>
@@ -84,6 +85,10 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
+  /** @return the number of tuples ever inserted into this table. Deleted tuples stay counted, so
+   * this is an upper-bound estimate meant for pre-sizing buffers, not an exact cardinality. */
+  inline auto GetInsertCount() const -> size_t { return insert_count_.load(std::memory_order_relaxed); }
+
   /**
    * Update a tuple in place. SHOULD NOT BE USED UNLESS YOU WANT TO OPTIMIZE FOR PROJECT 4.
    * @param meta new tuple meta
@@ -98,6 +103,7 @@ class TableHeap {
 
   std::mutex latch_;
   page_id_t last_page_id_{INVALID_PAGE_ID}; /* protected by latch_ */
+  std::atomic<size_t> insert_count_{0};
 };
 
 }  // namespace bustub
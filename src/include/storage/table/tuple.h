@@ -63,6 +63,11 @@ class Tuple {
   // constructor for creating a new tuple based on input value
   Tuple(std::vector<Value> values, const Schema *schema);
 
+  // Rebuild this tuple's contents from values, reusing the existing data buffer. Equivalent to
+  // assigning Tuple{values, schema} but takes the values by reference (no vector copy) and keeps
+  // the allocated capacity, for executors that emit row after row into the same output tuple.
+  void AssembleFrom(const std::vector<Value> &values, const Schema *schema);
+
   Tuple(const Tuple &other) = default;
 
   // move constructor
@@ -113,6 +113,42 @@ class Value {
     return Type::GetInstance(type_id_)->CompareGreaterThanEquals(*this, o);
   }
 
+  // Three-way comparison: negative / zero / positive for *this <, ==, > o. Matching non-null
+  // scalar types compare natively in one step; everything else falls back to the type system's
+  // less-than / greater-than pair. Intended for sort comparators, which otherwise pay two
+  // dispatched compares per key.
+  inline auto CompareThreeWay(const Value &o) const -> int {
+    if (type_id_ == o.type_id_ && !IsNull() && !o.IsNull()) {
+      switch (type_id_) {
+        case TypeId::BOOLEAN:
+        case TypeId::TINYINT:
+          return static_cast<int>(value_.tinyint_ > o.value_.tinyint_) -
+                 static_cast<int>(value_.tinyint_ < o.value_.tinyint_);
+        case TypeId::SMALLINT:
+          return static_cast<int>(value_.smallint_ > o.value_.smallint_) -
+                 static_cast<int>(value_.smallint_ < o.value_.smallint_);
+        case TypeId::INTEGER:
+          return static_cast<int>(value_.integer_ > o.value_.integer_) -
+                 static_cast<int>(value_.integer_ < o.value_.integer_);
+        case TypeId::BIGINT:
+          return static_cast<int>(value_.bigint_ > o.value_.bigint_) -
+                 static_cast<int>(value_.bigint_ < o.value_.bigint_);
+        case TypeId::DECIMAL:
+          return static_cast<int>(value_.decimal_ > o.value_.decimal_) -
+                 static_cast<int>(value_.decimal_ < o.value_.decimal_);
+        case TypeId::TIMESTAMP:
+          return static_cast<int>(value_.timestamp_ > o.value_.timestamp_) -
+                 static_cast<int>(value_.timestamp_ < o.value_.timestamp_);
+        default:
+          break;
+      }
+    }
+    if (CompareLessThan(o) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    return CompareGreaterThan(o) == CmpBool::CmpTrue ? 1 : 0;
+  }
+
   // Other mathematical functions
   inline auto Add(const Value &o) const -> Value { return Type::GetInstance(type_id_)->Add(*this, o); }
   inline auto Subtract(const Value &o) const -> Value { return Type::GetInstance(type_id_)->Subtract(*this, o); }
@@ -21,7 +21,7 @@ auto Optimizer::RewriteExpressionForJoin(const AbstractExpressionRef &expr, size
   for (const auto &child : expr->GetChildren()) {
     children.emplace_back(RewriteExpressionForJoin(child, left_column_cnt, right_column_cnt));
   }
-  if (const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+  if (const auto *column_value_expr = ExprCast<ColumnValueExpression>(expr.get());
       column_value_expr != nullptr) {
     BUSTUB_ENSURE(column_value_expr->GetTupleIdx() == 0, "tuple_idx cannot be value other than 0 before this stage.")
     auto col_idx = column_value_expr->GetColIdx();
@@ -37,7 +37,7 @@ auto Optimizer::RewriteExpressionForJoin(const AbstractExpressionRef &expr, size
 }
 
 auto Optimizer::IsPredicateTrue(const AbstractExpressionRef &expr) -> bool {
-  if (const auto *const_expr = dynamic_cast<const ConstantValueExpression *>(expr.get()); const_expr != nullptr) {
+  if (const auto *const_expr = ExprCast<ConstantValueExpression>(expr.get()); const_expr != nullptr) {
     return const_expr->val_.CastAs(TypeId::BOOLEAN).GetAs<bool>();
   }
   return false;
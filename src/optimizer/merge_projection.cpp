@@ -35,7 +35,7 @@ auto Optimizer::OptimizeMergeProjection(const AbstractPlanNodeRef &plan) -> Abst
       // If all items are column value expressions
       bool is_identical = true;
       for (size_t idx = 0; idx < exprs.size(); idx++) {
-        auto column_value_expr = dynamic_cast<const ColumnValueExpression *>(exprs[idx].get());
+        auto column_value_expr = ExprCast<ColumnValueExpression>(exprs[idx].get());
         if (column_value_expr != nullptr) {
           if (column_value_expr->GetTupleIdx() == 0 && column_value_expr->GetColIdx() == idx) {
             continue;
@@ -18,6 +18,44 @@
 
 namespace bustub {
 
+/** Extract a `<column> = <column>` conjunct with one side per child, bucketing the key
+ * expressions by tuple index. Each node is cast exactly once. Returns false when the expression
+ * is not such a comparison (including both columns referencing the same side). */
+static auto TryExtractEquiCondition(const AbstractExpression *expr, std::vector<AbstractExpressionRef> *left_keys,
+                                    std::vector<AbstractExpressionRef> *right_keys) -> bool {
+  const auto *cmp = ExprCast<ComparisonExpression>(expr);
+  if (cmp == nullptr || cmp->comp_type_ != ComparisonType::Equal) {
+    return false;
+  }
+  const auto *lhs = ExprCast<ColumnValueExpression>(cmp->children_[0].get());
+  const auto *rhs = ExprCast<ColumnValueExpression>(cmp->children_[1].get());
+  if (lhs == nullptr || rhs == nullptr || lhs->GetTupleIdx() == rhs->GetTupleIdx()) {
+    return false;
+  }
+  if (lhs->GetTupleIdx() == 0) {
+    left_keys->push_back(cmp->children_[0]);
+    right_keys->push_back(cmp->children_[1]);
+  } else {
+    left_keys->push_back(cmp->children_[1]);
+    right_keys->push_back(cmp->children_[0]);
+  }
+  return true;
+}
+
+/** Recurse across an arbitrary AND tree collecting equi-conditions, so three-key (and deeper)
+ * equijoins lower to hash joins instead of only the hand-unrolled two-clause form. Returns false
+ * as soon as any conjunct is not a usable equi-condition — the join then stays a nested loop
+ * with its full predicate rather than silently dropping the clause. */
+static auto CollectEquiConditions(const AbstractExpression *expr, std::vector<AbstractExpressionRef> *left_keys,
+                                  std::vector<AbstractExpressionRef> *right_keys) -> bool {
+  const auto *logic = ExprCast<LogicExpression>(expr);
+  if (logic != nullptr) {
+    return logic->logic_type_ == LogicType::And && CollectEquiConditions(logic->children_[0].get(), left_keys, right_keys) &&
+           CollectEquiConditions(logic->children_[1].get(), left_keys, right_keys);
+  }
+  return TryExtractEquiCondition(expr, left_keys, right_keys);
+}
+
 auto Optimizer::OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
   // TODO(student): implement NestedLoopJoin -> HashJoin optimizer rule
   // Note for 2023 Spring: You should at least support join keys of the form:
@@ -33,58 +71,15 @@ auto Optimizer::OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> Abstra
     const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*optimized_plan);
     // Has exactly two children
     BUSTUB_ENSURE(nlj_plan.children_.size() == 2, "NLJ should have exactly 2 children.");
-    // 1. Check if expr is equal condition where one is for the left table, and one is for the right table.
-    if (const auto *expr = dynamic_cast<const ComparisonExpression *>(nlj_plan.Predicate().get()); expr != nullptr) {
-      if (expr->comp_type_ == ComparisonType::Equal) {
-        if (const auto *left_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[0].get());
-            left_expr != nullptr) {
-          if (const auto *right_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[1].get());
-              right_expr != nullptr) {
-            auto left_expr_tuple_0 =
-                std::make_shared<ColumnValueExpression>(0, left_expr->GetColIdx(), left_expr->GetReturnType());
-            auto right_expr_tuple_1 =
-                std::make_shared<ColumnValueExpression>(1, right_expr->GetColIdx(), right_expr->GetReturnType());
-            // Now it's in form of <column_expr> = <column_expr>.
-            std::vector<AbstractExpressionRef> left_key_expressions;
-            std::vector<AbstractExpressionRef> right_key_expressions;
-            left_expr->GetTupleIdx() == 0 ? left_key_expressions.push_back(expr->children_[0])
-                                          : right_key_expressions.push_back(expr->children_[0]);
-            right_expr->GetTupleIdx() == 0 ? left_key_expressions.push_back(expr->children_[1])
-                                           : right_key_expressions.push_back(expr->children_[1]);
-            return std::make_shared<HashJoinPlanNode>(nlj_plan.output_schema_, nlj_plan.GetLeftPlan(),
-                                                      nlj_plan.GetRightPlan(), left_key_expressions,
-                                                      right_key_expressions, nlj_plan.GetJoinType());
-          }
-        }
-      }
-    }
-    // 2. Check if expr is logic condition
-    if (const auto *expr = dynamic_cast<const LogicExpression *>(nlj_plan.Predicate().get()); expr != nullptr) {
-      if (expr->logic_type_ == LogicType::And) {
-        std::vector<AbstractExpressionRef> left_key_expressions;
-        std::vector<AbstractExpressionRef> right_key_expressions;
-        for (int i = 0; i < 2; i++) {
-          const auto *child_expr = dynamic_cast<const ComparisonExpression *>(expr->children_[i].get());
-          if (nullptr == child_expr) {
-            continue;
-          }
-          const auto *left_expr = dynamic_cast<const ColumnValueExpression *>(child_expr->children_[0].get());
-          if (nullptr == left_expr) {
-            continue;
-          }
-          const auto *right_expr = dynamic_cast<const ColumnValueExpression *>(child_expr->children_[1].get());
-          if (nullptr == right_expr) {
-            continue;
-          }
-          left_expr->GetTupleIdx() == 0 ? left_key_expressions.push_back(child_expr->children_[0])
-                                        : right_key_expressions.push_back(child_expr->children_[0]);
-          right_expr->GetTupleIdx() == 0 ? left_key_expressions.push_back(child_expr->children_[1])
-                                         : right_key_expressions.push_back(child_expr->children_[1]);
-        }
-        return std::make_shared<HashJoinPlanNode>(nlj_plan.output_schema_, nlj_plan.GetLeftPlan(),
-                                                  nlj_plan.GetRightPlan(), left_key_expressions, right_key_expressions,
-                                                  nlj_plan.GetJoinType());
-      }
+    // Collect `<column expr> = <column expr>` conjuncts across the whole AND tree; any
+    // non-equi conjunct keeps the plan a nested loop join.
+    std::vector<AbstractExpressionRef> left_key_expressions;
+    std::vector<AbstractExpressionRef> right_key_expressions;
+    if (nlj_plan.Predicate() != nullptr &&
+        CollectEquiConditions(nlj_plan.Predicate().get(), &left_key_expressions, &right_key_expressions)) {
+      return std::make_shared<HashJoinPlanNode>(nlj_plan.output_schema_, nlj_plan.GetLeftPlan(),
+                                                nlj_plan.GetRightPlan(), left_key_expressions, right_key_expressions,
+                                                nlj_plan.GetJoinType());
     }
   }
 
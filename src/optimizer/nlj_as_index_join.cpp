@@ -44,11 +44,11 @@ auto Optimizer::OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> Abstr
     // Has exactly two children
     BUSTUB_ENSURE(nlj_plan.children_.size() == 2, "NLJ should have exactly 2 children.");
     // Check if expr is equal condition where one is for the left table, and one is for the right table.
-    if (const auto *expr = dynamic_cast<const ComparisonExpression *>(nlj_plan.Predicate().get()); expr != nullptr) {
+    if (const auto *expr = ExprCast<ComparisonExpression>(nlj_plan.Predicate().get()); expr != nullptr) {
       if (expr->comp_type_ == ComparisonType::Equal) {
-        if (const auto *left_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[0].get());
+        if (const auto *left_expr = ExprCast<ColumnValueExpression>(expr->children_[0].get());
             left_expr != nullptr) {
-          if (const auto *right_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[1].get());
+          if (const auto *right_expr = ExprCast<ColumnValueExpression>(expr->children_[1].get());
               right_expr != nullptr) {
             // Ensure both exprs have tuple_id == 0
             auto left_expr_tuple_0 =
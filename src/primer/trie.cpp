@@ -16,8 +16,8 @@ auto Trie::Get(std::string_view key) const -> const T * {
   auto p_node = root_;
   bool is_found = true;
   for (auto c : key) {
-    if (p_node && p_node->children_.find(c) != p_node->children_.end()) {
-      p_node = p_node->children_.at(c);
+    if (p_node && p_node->children_.Get(c)) {
+      p_node = p_node->children_.Get(c);
     } else {
       is_found = false;
       break;
@@ -48,7 +48,7 @@ auto Trie::Put(std::string_view key, T value) const -> Trie {
   if (nullptr == root_) {
     new_mutable_node = std::make_shared<TrieNode>();
   } else {
-    new_mutable_node = std::shared_ptr<TrieNode>(root_->Clone());
+    new_mutable_node = root_->CloneShared();
   }
 
   std::shared_ptr<TrieNode> last_node;
@@ -60,18 +60,18 @@ auto Trie::Put(std::string_view key, T value) const -> Trie {
   }
   for (int i = 0; i < size; i++) {
     auto c = key[i];
-    if (new_mutable_node->children_.find(c) != new_mutable_node->children_.end()) {
-      last_node = std::shared_ptr<TrieNode>(new_mutable_node->children_[c]->Clone());
+    if (new_mutable_node->children_.Get(c) != nullptr) {
+      last_node = new_mutable_node->children_.Get(c)->CloneShared();
     } else {
       last_node = std::make_shared<TrieNode>();
     }
     if (i == size - 1) {
       // we should create a value node
-      new_mutable_node->children_[c] =
-          std::make_shared<TrieNodeWithValue<T>>(last_node->children_, std::make_shared<T>(std::move(value)));
+      new_mutable_node->children_.Set(
+          c, std::make_shared<TrieNodeWithValue<T>>(last_node->children_, std::make_shared<T>(std::move(value))));
       break;
     }
-    new_mutable_node->children_[c] = last_node;
+    new_mutable_node->children_.Set(c, last_node);
     new_mutable_node = last_node;
   }
   return Trie(new_root);
@@ -88,7 +88,7 @@ auto Trie::Remove(std::string_view key) const -> Trie {
     return Trie(root_);
   }
   int size = key.size();
-  std::shared_ptr<TrieNode> new_mutable_node(root_->Clone());
+  std::shared_ptr<TrieNode> new_mutable_node = root_->CloneShared();
   std::shared_ptr<TrieNode> last_node;
   std::shared_ptr<const TrieNode> new_root = new_mutable_node;
   if (key.empty()) {
@@ -99,24 +99,24 @@ auto Trie::Remove(std::string_view key) const -> Trie {
 
   for (int i = 0; i < size; i++) {
     auto c = key[i];
-    if (new_mutable_node->children_.find(c) != new_mutable_node->children_.end()) {
-      last_node = std::shared_ptr<TrieNode>(new_mutable_node->children_[c]->Clone());
+    if (new_mutable_node->children_.Get(c) != nullptr) {
+      last_node = new_mutable_node->children_.Get(c)->CloneShared();
     } else {
       // not found let's quit
       break;
     }
     if (i == size - 1) {
       // last node ; delete or change to TrieNode
-      if (last_node->children_.empty()) {
-        new_mutable_node->children_.erase(c);
+      if (last_node->children_.Empty()) {
+        new_mutable_node->children_.Erase(c);
       } else if (last_node->is_value_node_) {
-        new_mutable_node->children_[c] = std::make_shared<TrieNode>(last_node->children_);
+        new_mutable_node->children_.Set(c, std::make_shared<TrieNode>(last_node->children_));
         LOG_DEBUG("new_mutable_node after remove is_value_node:%d index:%d char:%c",
-                  new_mutable_node->children_[c]->is_value_node_, i, c);
+                  new_mutable_node->children_.Get(c)->is_value_node_, i, c);
       }
       break;
     }
-    new_mutable_node->children_[c] = last_node;
+    new_mutable_node->children_.Set(c, last_node);
     new_mutable_node = last_node;
   }
 
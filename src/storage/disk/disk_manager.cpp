@@ -93,6 +93,26 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
   db_io_.flush();
 }
 
+/**
+ * Write a run of consecutive pages into the disk file with one seek and one flush
+ */
+void DiskManager::WritePages(page_id_t start_page_id, const std::vector<const char *> &pages) {
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  size_t offset = static_cast<size_t>(start_page_id) * BUSTUB_PAGE_SIZE;
+  num_writes_ += static_cast<int>(pages.size());
+  db_io_.seekp(offset);
+  for (const char *page_data : pages) {
+    db_io_.write(page_data, BUSTUB_PAGE_SIZE);
+  }
+  // check for I/O error
+  if (db_io_.bad()) {
+    LOG_DEBUG("I/O error while writing");
+    return;
+  }
+  // needs to flush to keep disk file in sync
+  db_io_.flush();
+}
+
 /**
  * Read the contents of the specified page into the given memory area
  */
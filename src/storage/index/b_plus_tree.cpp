@@ -1,3 +1,4 @@
+#include <iterator>
 #include <sstream>
 #include <string>
 
@@ -26,95 +27,132 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPool
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
-  auto guard = bpm_->FetchPageRead(header_page_id_);
-  auto header_page = guard.template As<BPlusTreeHeaderPage>();
-  if (nullptr != header_page && header_page->root_page_id_ != INVALID_PAGE_ID) {
-    auto root_page_guard = bpm_->FetchPageRead(header_page->root_page_id_);
-    auto root_page = root_page_guard.template As<BPlusTreePage>();
-    if (nullptr != root_page) {
-      return root_page->GetSize() == 0;
-    }
+auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return approx_size_.load(std::memory_order_relaxed) == 0; }
+/*
+ * Branch-free binary searches over the in-page key arrays. The point probes are memory-bound:
+ * each KeyAt(mid) touches a cache line the hardware prefetcher cannot predict, and the compare
+ * branch is close to random. Each step below halves the range with conditional-move-friendly
+ * updates instead of a taken/not-taken branch, and prefetches the midpoint of both possible next
+ * halves so the candidate lines stream in while the current compare executes.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafSlot(const LeafPage *leaf_page, const KeyType &key, bool *found) const -> int {
+  int base = 0;
+  int len = leaf_page->GetSize();
+  // Whenever the returned slot holds the key, some midpoint probe below compared equal on the way
+  // down, so equality is folded into the search for free and callers skip their own trailing
+  // comparator call on the result slot.
+  bool eq = false;
+  while (len > 0) {
+    const int half = len >> 1;
+    __builtin_prefetch(leaf_page->KeyPtrAt(base + (half >> 1)), 0, 0);
+    __builtin_prefetch(leaf_page->KeyPtrAt(base + half + ((len - half) >> 1)), 0, 0);
+    const int cmp = comparator_(leaf_page->KeyAt(base + half), key);
+    eq = eq || cmp == 0;
+    const bool go_right = cmp < 0;
+    base = go_right ? base + half + 1 : base;
+    len = go_right ? len - half - 1 : half;
+  }
+  *found = eq;
+  return base;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindChildSlot(const InternalPage *internal_page, const KeyType &key) const -> int {
+  int base = 1;  // separators live at [1, size)
+  int len = internal_page->GetSize() - 1;
+  while (len > 0) {
+    const int half = len >> 1;
+    __builtin_prefetch(internal_page->KeyPtrAt(base + (half >> 1)), 0, 0);
+    __builtin_prefetch(internal_page->KeyPtrAt(base + half + ((len - half) >> 1)), 0, 0);
+    const bool go_right = comparator_(key, internal_page->KeyAt(base + half)) > 0;
+    base = go_right ? base + half + 1 : base;
+    len = go_right ? len - half - 1 : half;
+  }
+  return base - 1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindSeparatorSlot(const InternalPage *internal_page, const KeyType &key) const -> int {
+  // A forward scan, not a binary search: this only runs when a split inserts into the parent, the
+  // separator count is bounded by internal_max_size_, and a sequential walk over the key array is
+  // perfectly predicted and prefetched, which beats binary probing at these node sizes.
+  const int size = internal_page->GetSize();
+  int slot = 1;
+  while (slot < size && comparator_(internal_page->KeyAt(slot), key) <= 0) {
+    slot++;
   }
-  return true;
+  return slot;
 }
+
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
- * This method is used for point query
- * @return : true means key exists
+ * Shared read-side descent: GetValue and Begin(key) walk the internal levels identically, so one
+ * copy keeps the hot path small and in one place (the write paths keep their own loops because
+ * they interleave operation-specific latch crabbing with the descent).
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
-  // Declaration of context instance.
-  // Context ctx;
-  // (void)ctx;
-  auto guard = bpm_->FetchPageRead(header_page_id_);
-  auto header_page = guard.template As<BPlusTreeHeaderPage>();
-  if (nullptr == header_page || header_page->root_page_id_ == INVALID_PAGE_ID) {
-    return false;
-  }
-  auto start_page_id = header_page->root_page_id_;
-  guard.Drop();
+auto BPLUSTREE_TYPE::DescendToLeaf(const KeyType &key, page_id_t start_page_id, ReadPageGuard *leaf_guard)
+    -> const LeafPage * {
   do {
     auto page_guard = bpm_->FetchPageRead(start_page_id);
     auto page = page_guard.template As<BPlusTreePage>();
     if (nullptr == page) {
-      return false;
+      return nullptr;
     }
-    // use binary search to avoid overtime
     auto size = page->GetSize();
     if (0 == size) {
-      return false;
+      return nullptr;
     }
     if (page->IsLeafPage()) {
-      auto leaf_page = reinterpret_cast<const LeafPage *>(page);
-      if (nullptr == leaf_page) {
-        return false;
-      }
-      int right = size - 1;
-      int left = 0;
-      int mid = left;
-      while (left <= right) {
-        mid = left + (right - left) / 2;
-        const auto page_key = leaf_page->KeyAt(mid);
-        if (comparator_(key, page_key) >= 0) {
-          if (0 == comparator_(key, page_key)) {
-            result->push_back(leaf_page->ValueAt(mid));
-            return true;
-          }
-          left = mid + 1;
-        } else {
-          right = mid - 1;
-        }
-      }
-      // LOG_WARN("Value Not Found! last index: %d", mid);
-      break;
+      *leaf_guard = std::move(page_guard);
+      return reinterpret_cast<const LeafPage *>(leaf_guard->GetData());
     }
     auto internal_page = reinterpret_cast<const InternalPage *>(page);
-    if (nullptr == internal_page) {
-      return false;
-    }
     if (size <= 1) {
-      return false;
+      return nullptr;
     }
-    int right = size - 1;
-    int left = 1;
-    int mid = left;
-    while (left <= right) {
-      mid = left + (right - left) / 2;
-      const auto page_key = internal_page->KeyAt(mid);
-      if (comparator_(key, page_key) > 0) {
-        left = mid + 1;
-      } else {
-        right = mid - 1;
-        mid -= 1;
-      }
-    }
-    start_page_id = internal_page->ValueAt(mid);
+    start_page_id = internal_page->ValueAt(FindChildSlot(internal_page, key));
+    // If the child is resident, warm its header lines while the fetch and guard bookkeeping for
+    // the next level run; a nullptr (pool miss) makes the prefetch a harmless no-op.
+    __builtin_prefetch(bpm_->PeekFrameData(start_page_id), 0, 1);
   } while (start_page_id != INVALID_PAGE_ID);
+  return nullptr;
+}
+
+/*
+ * Return the only value that associated with input key
+ * This method is used for point query
+ * @return : true means key exists
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
+  // Declaration of context instance.
+  // Context ctx;
+  // (void)ctx;
+  auto start_page_id = cached_root_page_id_.load(std::memory_order_acquire);
+  if (start_page_id == INVALID_PAGE_ID) {
+    auto guard = bpm_->FetchPageRead(header_page_id_);
+    auto header_page = guard.template As<BPlusTreeHeaderPage>();
+    if (nullptr == header_page || header_page->root_page_id_ == INVALID_PAGE_ID) {
+      return false;
+    }
+    start_page_id = header_page->root_page_id_;
+  }
+  ReadPageGuard leaf_guard;
+  auto leaf_page = DescendToLeaf(key, start_page_id, &leaf_guard);
+  if (nullptr == leaf_page) {
+    return false;
+  }
+  bool found;
+  const int slot = FindLeafSlot(leaf_page, key, &found);
+  if (found) {
+    result->push_back(leaf_page->ValueAt(slot));
+    return true;
+  }
+  // LOG_WARN("Value Not Found! last index: %d", slot);
   return false;
 }
 
@@ -130,25 +168,118 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
-  // Declaration of context instance.
-  Context ctx;
-  auto guard = bpm_->FetchPageWrite(header_page_id_);
-  auto header_page = guard.template AsMut<BPlusTreeHeaderPage>();
-  if (nullptr == header_page) {
-    return false;
+  // Rightmost-leaf fast path: monotonically increasing streams always append to the same leaf,
+  // so skip the descent entirely when the cached rightmost leaf accepts the key. Everything is
+  // re-validated under the leaf's write latch; the hint re-check after latching matters because
+  // a merge can orphan a page that still looks rightmost (merges invalidate the hint before
+  // releasing their latches, so a latched-then-re-read hint is trustworthy).
+  {
+    auto rightmost = rightmost_leaf_.load(std::memory_order_acquire);
+    if (rightmost != INVALID_PAGE_ID) {
+      auto leaf_guard = bpm_->FetchPageWrite(rightmost);
+      auto leaf_page = leaf_guard.template AsMut<LeafPage>();
+      if (nullptr != leaf_page && rightmost_leaf_.load(std::memory_order_acquire) == rightmost &&
+          leaf_page->IsLeafPage() && leaf_page->GetNextPageId() == INVALID_PAGE_ID &&
+          leaf_page->GetSize() + 1 < leaf_max_size_) {
+        const int size = leaf_page->GetSize();
+        if (size > 0 && comparator_(leaf_page->KeyAt(size - 1), key) < 0) {
+          leaf_page->InsertAt(size, {key, value});
+          approx_size_.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+      }
+    }
+  }
+  auto start_page_id = cached_root_page_id_.load(std::memory_order_acquire);
+  if (start_page_id == INVALID_PAGE_ID) {
+    // Root not cached yet. Probe with a shared latch first: when another thread already created
+    // the root (or the cache is simply cold after a restart), an exclusive header latch would
+    // serialize every inserter for nothing. Only an actually-empty tree upgrades to write.
+    {
+      auto guard = bpm_->FetchPageRead(header_page_id_);
+      auto header_page = guard.template As<BPlusTreeHeaderPage>();
+      if (nullptr == header_page) {
+        return false;
+      }
+      start_page_id = header_page->root_page_id_;
+    }
+    if (start_page_id == INVALID_PAGE_ID) {
+      // Root creation serializes through the header write latch; re-test under it since another
+      // inserter can win the race between the probe above and this latch.
+      auto guard = bpm_->FetchPageWrite(header_page_id_);
+      auto header_page = guard.template AsMut<BPlusTreeHeaderPage>();
+      if (nullptr == header_page) {
+        return false;
+      }
+      if (header_page->root_page_id_ == INVALID_PAGE_ID) {
+        // init first page
+        auto root_guard = bpm_->NewPageGuarded(&header_page->root_page_id_);
+        auto page = root_guard.template AsMut<LeafPage>();
+        page->SetMaxSize(leaf_max_size_);
+        page->SetPageType(IndexPageType::LEAF_PAGE);
+        page->SetSize(0);
+        page->SetNextPageId(INVALID_PAGE_ID);
+      }
+      start_page_id = header_page->root_page_id_;
+    }
+    cached_root_page_id_.store(start_page_id, std::memory_order_release);
   }
-  if (header_page->root_page_id_ == INVALID_PAGE_ID) {
-    // init first page
-    auto root_guard = bpm_->NewPageGuarded(&header_page->root_page_id_);
-    auto page = root_guard.template AsMut<LeafPage>();
-    page->SetMaxSize(leaf_max_size_);
-    page->SetPageType(IndexPageType::LEAF_PAGE);
-    page->SetSize(0);
-    page->SetNextPageId(INVALID_PAGE_ID);
+  // Optimistic pass: most inserts land in a leaf with room and never split, so descend with
+  // shared latches and write-latch only the leaf. The parent's read latch is held across the
+  // leaf's write acquisition, and any structural change to that leaf has to come through the
+  // pessimistic descent below, which write-latches the parent first -- so once the leaf latch is
+  // taken, only its size can have moved. A leaf that would split falls through to that descent.
+  {
+    ReadPageGuard parent_guard;
+    auto page_id = start_page_id;
+    while (true) {
+      auto child_guard = bpm_->FetchPageRead(page_id);
+      auto child = child_guard.template As<BPlusTreePage>();
+      if (nullptr == child || child->GetSize() == 0) {
+        break;
+      }
+      if (child->IsLeafPage()) {
+        child_guard.Drop();
+        auto leaf_guard = bpm_->FetchPageWrite(page_id);
+        auto leaf_page = leaf_guard.template AsMut<LeafPage>();
+        // The root is reused in place when it splits, so with no parent held it may have turned
+        // into an internal page between the probe above and this latch: re-check both.
+        if (nullptr == leaf_page || !leaf_page->IsLeafPage() || leaf_page->GetSize() + 1 >= leaf_max_size_) {
+          break;
+        }
+        bool found;
+        const int slot = FindLeafSlot(leaf_page, key, &found);
+        if (found) {  // duplicate key
+          return false;
+        }
+        leaf_page->InsertAt(slot, {key, value});
+        approx_size_.fetch_add(1, std::memory_order_relaxed);
+        if (leaf_page->GetNextPageId() == INVALID_PAGE_ID) {
+          rightmost_leaf_.store(page_id, std::memory_order_release);
+        }
+        return true;
+      }
+      auto internal_page = reinterpret_cast<const InternalPage *>(child);
+      if (internal_page->GetSize() <= 1) {
+        break;
+      }
+      page_id = internal_page->ValueAt(FindChildSlot(internal_page, key));
+      __builtin_prefetch(bpm_->PeekFrameData(page_id), 0, 1);
+      parent_guard = std::move(child_guard);
+    }
   }
-  auto start_page_id = header_page->root_page_id_;
-  ctx.root_page_id_ = header_page->root_page_id_;
-  guard.Drop();
+  return InsertSlow(key, value, start_page_id);
+}
+
+/*
+ * Pessimistic insert: full crab-latched descent with proactive splits. Kept out of Insert so
+ * the optimistic fast path above stays a small, contiguous block of hot code.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertSlow(const KeyType &key, const ValueType &value, page_id_t start_page_id) -> bool {
+  // Declaration of context instance.
+  Context ctx;
+  ctx.root_page_id_ = start_page_id;
   do {
     ctx.write_set_.push_back(bpm_->FetchPageWrite(start_page_id));
     auto page = ctx.write_set_.back().template AsMut<BPlusTreePage>();
@@ -157,49 +288,34 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
     }
     auto size = page->GetSize();
     if (size > 3 && size >= page->GetMaxSize()) {  // split before insertion for internal page
-      DoSplit(ctx);
+      DoSplit(ctx, page, size);
       page = ctx.write_set_.back().template AsMut<BPlusTreePage>();
+      size = page->GetSize();  // the split replaced the node under us
     }
-    if (nullptr == page) {
-      return false;
-    }
-    // judge if this node will split;if not, we could release the latch of grandparent or above beforehand
-    while (ctx.write_set_.size() > 2 && size < page->GetMaxSize()) {
+    // Release ancestors only if this node stays legal after the operation it is about to take
+    // part in (mirrors RemoveSlow). An internal page absorbs a pushed-up separator as long as it
+    // is below max; a leaf splits when the pending insert fills it, so it still needs its parent
+    // latched at size == max - 1.
+    while (ctx.write_set_.size() > 1 &&
+           (page->IsLeafPage() ? size + 1 < page->GetMaxSize() : size < page->GetMaxSize())) {
       auto &tmp_guard = ctx.write_set_.front();
       tmp_guard.Drop();
       ctx.write_set_.pop_front();
     }
-    size = page->GetSize();
     if (page->IsLeafPage()) {
       auto leaf_page = reinterpret_cast<LeafPage *>(page);
-      int left = 0;
-      int right = size > 0 ? size - 1 : 0;
-      int mid = left;
-      while (size > 0 && left <= right) {  // lower_bound
-        mid = left + (right - left) / 2;
-        const auto page_key = leaf_page->KeyAt(mid);
-        if (comparator_(key, page_key) >= 0) {
-          if (0 == comparator_(key, page_key)) {  // duplicate key
-            return false;
-          }
-          left = mid + 1;
-        } else if (0 > comparator_(key, page_key)) {
-          right = mid - 1;
-        }
-      }
-      if (size > 0) {  // avoid UB if size is zero
-        const auto page_key = leaf_page->KeyAt(mid);
-        if (0 > comparator_(key, page_key)) {
-          leaf_page->InsertAt(mid, {key, value});
-        } else {
-          leaf_page->InsertAt(mid + 1, {key, value});
-        }
-      } else {
-        leaf_page->InsertAt(mid, {key, value});
+      bool found;
+      const int slot = FindLeafSlot(leaf_page, key, &found);
+      if (found) {  // duplicate key
+        return false;
       }
+      leaf_page->InsertAt(slot, {key, value});
+      approx_size_.fetch_add(1, std::memory_order_relaxed);
       size = leaf_page->GetSize();
       if (size >= leaf_max_size_) {
-        DoSplit(ctx);
+        DoSplit(ctx, page, size);
+      } else if (leaf_page->GetNextPageId() == INVALID_PAGE_ID) {
+        rightmost_leaf_.store(ctx.write_set_.back().PageId(), std::memory_order_release);
       }
       return true;
     }
@@ -210,20 +326,10 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
     if (size <= 1) {
       return false;
     }
-    int right = size - 1;
-    int left = 1;
-    int mid = left;
-    while (left <= right) {
-      mid = left + (right - left) / 2;
-      const auto page_key = internal_page->KeyAt(mid);
-      if (comparator_(key, page_key) > 0) {
-        left = mid + 1;
-      } else if (0 >= comparator_(key, page_key)) {
-        right = mid - 1;
-        mid -= 1;
-      }
-    }
-    start_page_id = internal_page->ValueAt(mid);
+    start_page_id = internal_page->ValueAt(FindChildSlot(internal_page, key));
+    // If the child is resident, warm its header lines while the fetch and guard bookkeeping for
+    // the next level run; a nullptr (pool miss) makes the prefetch a harmless no-op.
+    __builtin_prefetch(bpm_->PeekFrameData(start_page_id), 0, 1);
   } while (start_page_id != INVALID_PAGE_ID);
   return false;
 }
@@ -240,19 +346,72 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
-  // Declaration of context instance.
-  Context ctx;
-  auto guard = bpm_->FetchPageWrite(header_page_id_);
-  auto header_page = guard.template AsMut<BPlusTreeHeaderPage>();
-  if (nullptr == header_page) {
-    return;
+  auto start_page_id = cached_root_page_id_.load(std::memory_order_acquire);
+  if (start_page_id == INVALID_PAGE_ID) {
+    // Remove never mutates the header, so a shared latch is enough to read the root id.
+    auto guard = bpm_->FetchPageRead(header_page_id_);
+    auto header_page = guard.template As<BPlusTreeHeaderPage>();
+    if (nullptr == header_page || header_page->root_page_id_ == INVALID_PAGE_ID) {
+      return;
+    }
+    start_page_id = header_page->root_page_id_;
+    cached_root_page_id_.store(start_page_id, std::memory_order_release);
   }
-  if (header_page->root_page_id_ == INVALID_PAGE_ID) {
-    return;
+  // Optimistic pass, mirroring Insert: most removals leave the leaf legal and never merge, so
+  // descend with shared latches and write-latch only the leaf. Structural changes must come
+  // through the pessimistic descent below, which write-latches the parent first, so holding the
+  // parent's read latch across the leaf's write acquisition pins the structure in place. A leaf
+  // that would underflow falls through; the root leaf never merges, so it is always safe.
+  {
+    ReadPageGuard parent_guard;
+    auto page_id = start_page_id;
+    while (true) {
+      auto child_guard = bpm_->FetchPageRead(page_id);
+      auto child = child_guard.template As<BPlusTreePage>();
+      if (nullptr == child || child->GetSize() == 0) {
+        break;
+      }
+      if (child->IsLeafPage()) {
+        child_guard.Drop();
+        auto leaf_guard = bpm_->FetchPageWrite(page_id);
+        auto leaf_page = leaf_guard.template AsMut<LeafPage>();
+        // The root is reused in place when it splits, so with no parent held it may have turned
+        // into an internal page between the probe above and this latch: re-check both.
+        if (nullptr == leaf_page || !leaf_page->IsLeafPage()) {
+          break;
+        }
+        if (page_id != start_page_id && leaf_page->GetSize() - 1 < leaf_page->GetMinSize()) {
+          break;
+        }
+        bool found;
+        const int slot = FindLeafSlot(leaf_page, key, &found);
+        if (found) {
+          leaf_page->RemoveAt(slot);
+          approx_size_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return;
+      }
+      auto internal_page = reinterpret_cast<const InternalPage *>(child);
+      if (internal_page->GetSize() <= 1) {
+        break;
+      }
+      page_id = internal_page->ValueAt(FindChildSlot(internal_page, key));
+      __builtin_prefetch(bpm_->PeekFrameData(page_id), 0, 1);
+      parent_guard = std::move(child_guard);
+    }
   }
-  auto start_page_id = header_page->root_page_id_;
-  ctx.root_page_id_ = header_page->root_page_id_;
-  guard.Drop();
+  RemoveSlow(key, start_page_id);
+}
+
+/*
+ * Pessimistic remove: full crab-latched descent with reactive merges. Kept out of Remove so the
+ * optimistic fast path above stays a small, contiguous block of hot code.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveSlow(const KeyType &key, page_id_t start_page_id) {
+  // Declaration of context instance.
+  Context ctx;
+  ctx.root_page_id_ = start_page_id;
   do {
     ctx.write_set_.push_back(bpm_->FetchPageWrite(start_page_id));
     auto page = ctx.write_set_.back().template AsMut<BPlusTreePage>();
@@ -261,28 +420,25 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
     }
     auto size = page->GetSize();
     if (size > 3 && size >= page->GetMaxSize()) {  // split before insertion for internal page
-      DoSplit(ctx);
+      DoSplit(ctx, page, size);
       page = ctx.write_set_.back().template AsMut<BPlusTreePage>();
+      size = page->GetSize();  // the split replaced the node under us
+    }
+    // A node that stays legal after losing one entry stops any merge from propagating past it
+    // (DoMerge re-checks the size at every level), so every latch above it can be released now.
+    while (ctx.write_set_.size() > 1 && size > page->GetMinSize() && (page->IsLeafPage() || size > 2)) {
+      auto &tmp_guard = ctx.write_set_.front();
+      tmp_guard.Drop();
+      ctx.write_set_.pop_front();
     }
-    size = page->GetSize();
     if (page->IsLeafPage()) {
       auto leaf_page = reinterpret_cast<LeafPage *>(page);
-      int left = 0;
-      int right = size > 0 ? size - 1 : 0;
-      int mid = left;
-      while (size > 0 && left <= right) {  // lower_bound
-        mid = left + (right - left) / 2;
-        const auto page_key = leaf_page->KeyAt(mid);
-        if (comparator_(key, page_key) >= 0) {
-          if (0 == comparator_(key, page_key)) {
-            leaf_page->RemoveAt(mid);
-            DoMerge(ctx);
-            return;
-          }
-          left = mid + 1;
-        } else if (0 > comparator_(key, page_key)) {
-          right = mid - 1;
-        }
+      bool found;
+      const int slot = FindLeafSlot(leaf_page, key, &found);
+      if (found) {
+        leaf_page->RemoveAt(slot);
+        approx_size_.fetch_sub(1, std::memory_order_relaxed);
+        DoMerge(ctx, page, size - 1);
       }
       return;
     }
@@ -293,20 +449,10 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
     if (size <= 1) {
       return;
     }
-    int right = size - 1;
-    int left = 1;
-    int mid = left;
-    while (left <= right) {
-      mid = left + (right - left) / 2;
-      const auto page_key = internal_page->KeyAt(mid);
-      if (comparator_(key, page_key) > 0) {
-        left = mid + 1;
-      } else if (0 >= comparator_(key, page_key)) {
-        right = mid - 1;
-        mid -= 1;
-      }
-    }
-    start_page_id = internal_page->ValueAt(mid);
+    start_page_id = internal_page->ValueAt(FindChildSlot(internal_page, key));
+    // If the child is resident, warm its header lines while the fetch and guard bookkeeping for
+    // the next level run; a nullptr (pool miss) makes the prefetch a harmless no-op.
+    __builtin_prefetch(bpm_->PeekFrameData(start_page_id), 0, 1);
   } while (start_page_id != INVALID_PAGE_ID);
 }
 
@@ -320,13 +466,15 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
-  auto guard = bpm_->FetchPageRead(header_page_id_);
-  auto header_page = guard.template As<BPlusTreeHeaderPage>();
-  if (nullptr == header_page || header_page->root_page_id_ == INVALID_PAGE_ID) {
-    return End();
+  auto start_page_id = cached_root_page_id_.load(std::memory_order_acquire);
+  if (start_page_id == INVALID_PAGE_ID) {
+    auto guard = bpm_->FetchPageRead(header_page_id_);
+    auto header_page = guard.template As<BPlusTreeHeaderPage>();
+    if (nullptr == header_page || header_page->root_page_id_ == INVALID_PAGE_ID) {
+      return End();
+    }
+    start_page_id = header_page->root_page_id_;
   }
-  auto start_page_id = header_page->root_page_id_;
-  guard.Drop();
   do {
     auto page_guard = bpm_->FetchPageRead(start_page_id);
     auto page = page_guard.template As<BPlusTreePage>();
@@ -362,74 +510,27 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
-  auto guard = bpm_->FetchPageRead(header_page_id_);
-  auto header_page = guard.template As<BPlusTreeHeaderPage>();
-  if (nullptr == header_page || header_page->root_page_id_ == INVALID_PAGE_ID) {
+  auto start_page_id = cached_root_page_id_.load(std::memory_order_acquire);
+  if (start_page_id == INVALID_PAGE_ID) {
+    auto guard = bpm_->FetchPageRead(header_page_id_);
+    auto header_page = guard.template As<BPlusTreeHeaderPage>();
+    if (nullptr == header_page || header_page->root_page_id_ == INVALID_PAGE_ID) {
+      return End();
+    }
+    start_page_id = header_page->root_page_id_;
+  }
+  ReadPageGuard leaf_guard;
+  auto leaf_page = DescendToLeaf(key, start_page_id, &leaf_guard);
+  if (nullptr == leaf_page) {
     return End();
   }
-  auto start_page_id = header_page->root_page_id_;
-  guard.Drop();
-  int index = -1;
-  do {
-    auto page_guard = bpm_->FetchPageRead(start_page_id);
-    auto page = page_guard.template As<BPlusTreePage>();
-    if (nullptr == page) {
-      break;
-    }
-    // use binary search to avoid overtime
-    auto size = page->GetSize();
-    if (0 == size) {
-      break;
-    }
-    if (page->IsLeafPage()) {
-      auto leaf_page = reinterpret_cast<const LeafPage *>(page);
-      if (nullptr == leaf_page) {
-        break;
-      }
-      int right = size - 1;
-      int left = 0;
-      int mid = left;
-      while (left <= right) {
-        mid = left + (right - left) / 2;
-        const auto page_key = leaf_page->KeyAt(mid);
-        if (comparator_(key, page_key) >= 0) {
-          if (0 == comparator_(key, page_key)) {
-            index = mid;
-            break;
-          }
-          left = mid + 1;
-        } else if (0 > comparator_(key, page_key)) {
-          right = mid - 1;
-        }
-      }
-      break;
-    }
-    auto internal_page = reinterpret_cast<const InternalPage *>(page);
-    if (nullptr == internal_page) {
-      break;
-    }
-    if (size <= 1) {
-      break;
-    }
-    int right = size - 1;
-    int left = 1;
-    int mid = left;
-    while (left <= right) {
-      mid = left + (right - left) / 2;
-      const auto page_key = internal_page->KeyAt(mid);
-      if (comparator_(key, page_key) > 0) {
-        left = mid + 1;
-      } else if (0 >= comparator_(key, page_key)) {
-        right = mid - 1;
-        mid -= 1;
-      }
-    }
-    start_page_id = internal_page->ValueAt(mid);
-  } while (start_page_id != INVALID_PAGE_ID);
-  if (index < 0) {
+  bool found;
+  const int slot = FindLeafSlot(leaf_page, key, &found);
+  if (!found) {
     return End();
   }
-  return INDEXITERATOR_TYPE(bpm_, bpm_->FetchPageRead(start_page_id), index);
+  // Hand the already-latched leaf to the iterator instead of dropping it and re-fetching.
+  return INDEXITERATOR_TYPE(bpm_, std::move(leaf_guard), slot);
 }
 
 /*
@@ -445,6 +546,10 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(bpm
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
+  auto root_page_id = cached_root_page_id_.load(std::memory_order_acquire);
+  if (root_page_id != INVALID_PAGE_ID) {
+    return root_page_id;
+  }
   auto guard = bpm_->FetchPageRead(header_page_id_);
   auto header_page = guard.template As<BPlusTreeHeaderPage>();
   return header_page->root_page_id_;
@@ -455,21 +560,16 @@ auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
  * @return : void
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::DoSplit(Context &ctx) {  // Split once; Avoid holding latch for too long
-  if (ctx.write_set_.empty()) {
-    LOG_DEBUG("Splitting empty write_set");
-    return;
-  }
+void BPLUSTREE_TYPE::DoSplit(Context &ctx, BPlusTreePage *page, int size) {  // Split once; Avoid holding latch too long
+  // `page` and `size` are the caller's already-loaded view of write_set_.back(): every call site
+  // has just confirmed size >= max, so the old defensive reload-and-recheck prologue is gone.
   auto page_guard = std::move(ctx.write_set_.back());
   ctx.write_set_.pop_back();
-  auto page = page_guard.template AsMut<BPlusTreePage>();
-  // check size
-  int size = page->GetSize();
-  if (page->GetSize() < page->GetMaxSize()) {
-    LOG_DEBUG("CurSize(%d) MaxSize(%d) No Need To Split", page->GetSize(), page->GetMaxSize());
-    return;
-  }
   // make sure root_page_id do not change to avoid gaining the latch of header_page
+  // Keeping the root id immutable costs one extra half-page copy per root split (the lower half
+  // could otherwise stay put while a freshly allocated page became the new root), but it is what
+  // lets cached_root_page_id_ readers start their descent without ever validating the id: a
+  // root split is O(log n)-rare while that cache is read on every single operation.
   if (ctx.IsRootPage(page_guard.PageId())) {
     // find the mid point to split
     if (page->IsLeafPage()) {
@@ -491,12 +591,8 @@ void BPLUSTREE_TYPE::DoSplit(Context &ctx) {  // Split once; Avoid holding latch
       right_child_page->SetSize(size - mid - 1);
       right_child_page->SetNextPageId(INVALID_PAGE_ID);
       auto mid_key = leaf_page->KeyAt(mid);
-      for (int i = 0; i <= mid; i++) {
-        left_child_page->SetMappingAt(i, leaf_page->MappingAt(i));
-      }
-      for (int i = mid + 1; i < size; i++) {
-        right_child_page->SetMappingAt(i - mid - 1, leaf_page->MappingAt(i));
-      }
+      left_child_page->CopyMappings(0, leaf_page, 0, mid + 1);
+      right_child_page->CopyMappings(0, leaf_page, mid + 1, size - mid - 1);
       auto leaf_internal_page = reinterpret_cast<InternalPage *>(page);
       leaf_internal_page->SetPageType(IndexPageType::INTERNAL_PAGE);
       leaf_internal_page->SetMappingAt(0, {KeyType{}, left_page_guard.PageId()});
@@ -520,13 +616,9 @@ void BPLUSTREE_TYPE::DoSplit(Context &ctx) {  // Split once; Avoid holding latch
       right_child_page->SetMaxSize(internal_max_size_);
       right_child_page->SetSize(size - mid);
       auto mid_key = internal_page->KeyAt(mid);
-      for (int i = 0; i < mid; i++) {
-        left_child_page->SetMappingAt(i, internal_page->MappingAt(i));
-      }
+      left_child_page->CopyMappings(0, internal_page, 0, mid);
       right_child_page->SetMappingAt(0, {KeyType{}, internal_page->ValueAt(mid)});
-      for (int i = mid + 1; i < size; i++) {
-        right_child_page->SetMappingAt(i - mid, internal_page->MappingAt(i));
-      }
+      right_child_page->CopyMappings(1, internal_page, mid + 1, size - mid - 1);
       internal_page->SetMappingAt(0, {KeyType{}, left_page_guard.PageId()});
       internal_page->SetMappingAt(1, {mid_key, right_page_guard.PageId()});
       internal_page->SetSize(2);
@@ -564,27 +656,9 @@ void BPLUSTREE_TYPE::DoSplit(Context &ctx) {  // Split once; Avoid holding latch
       right_child_page->SetSize(size - mid - 1);
       right_child_page->SetNextPageId(leaf_page->GetNextPageId());
       leaf_page->SetNextPageId(right_page_guard.PageId());
-      for (int i = mid + 1; i < size; i++) {
-        right_child_page->SetMappingAt(i - mid - 1, leaf_page->MappingAt(i));
-      }
+      right_child_page->CopyMappings(0, leaf_page, mid + 1, size - mid - 1);
       // insert mid_key into parent node
-      int index = 1;
-      int left = 1;
-      int right = parent_size - 1;
-      while (left <= right) {  // lower_bound
-        index = left + (right - left) / 2;
-        auto key = parent_page->KeyAt(index);
-        if (comparator_(key, mid_key) > 0) {
-          right = index - 1;
-        } else if (0 >= comparator_(key, mid_key)) {
-          left = index + 1;
-        }
-      }
-      auto page_key = parent_page->KeyAt(index);
-      if (0 > comparator_(page_key, mid_key)) {
-        index += 1;
-      }
-      parent_page->InsertAt(index, {mid_key, right_page_guard.PageId()});
+      parent_page->InsertAt(FindSeparatorSlot(parent_page, mid_key), {mid_key, right_page_guard.PageId()});
       // clean up left child
       leaf_page->SetSize(mid + 1);
       ctx.write_set_.push_back(std::move(parent_page_guard));
@@ -613,29 +687,10 @@ void BPLUSTREE_TYPE::DoSplit(Context &ctx) {  // Split once; Avoid holding latch
       right_child_page->SetMaxSize(internal_max_size_);
       right_child_page->SetSize(size - mid);
       right_child_page->SetMappingAt(0, {KeyType{}, internal_page->ValueAt(mid)});
-      for (int i = mid + 1; i < size; i++) {
-        right_child_page->SetMappingAt(i - mid, internal_page->MappingAt(i));
-      }
+      right_child_page->CopyMappings(1, internal_page, mid + 1, size - mid - 1);
       internal_page->SetSize(mid);
       // insert mid_key into parent node
-      int index = 1;
-      int left = 1;
-      int right = parent_size - 1;
-      while (left <= right) {  // lower_bound
-        index = left + (right - left) / 2;
-        auto key = parent_page->KeyAt(index);
-        if (comparator_(key, mid_key) > 0) {
-          right = index - 1;
-          index = right;
-        } else if (0 >= comparator_(key, mid_key)) {
-          left = index + 1;
-        }
-      }
-      auto page_key = parent_page->KeyAt(index);
-      if (0 > comparator_(page_key, mid_key)) {
-        index += 1;
-      }
-      parent_page->InsertAt(index, {mid_key, right_page_guard.PageId()});
+      parent_page->InsertAt(FindSeparatorSlot(parent_page, mid_key), {mid_key, right_page_guard.PageId()});
       ctx.write_set_.push_back(std::move(parent_page_guard));
     }
   }
@@ -646,27 +701,21 @@ void BPLUSTREE_TYPE::DoSplit(Context &ctx) {  // Split once; Avoid holding latch
  * @return : void
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::DoMerge(Context &ctx) {
-  if (ctx.write_set_.empty()) {
-    LOG_DEBUG("Merging empty write_set");
-    return;
-  }
+void BPLUSTREE_TYPE::DoMerge(Context &ctx, BPlusTreePage *page, int size) {
+  // `page` and `size` are the caller's post-removal view of write_set_.back(), saving the reload.
   auto page_guard = std::move(ctx.write_set_.back());
   ctx.write_set_.pop_back();
-  auto page = page_guard.template AsMut<BPlusTreePage>();
-  // check size
-  int size = page->GetSize();
   // Note: if node is half-full, no need rebalancing
   // Internal node size must greater than 1!
   if ((page->IsLeafPage() || size > 1) && size >= page->GetMinSize()) {
     return;
   }
 
+  // Single upward sweep: every parent comes off ctx.write_set_ (latched during the descent), so
+  // propagation never re-fetches an ancestor; only siblings are fetched, and lazily. Each merge
+  // branch below returns as soon as its parent is left legal (size > 1), so reaching the bottom
+  // of the loop means the current level still underflows -- no per-level recheck is needed here.
   while (!ctx.write_set_.empty()) {
-    if ((page->IsLeafPage() || page->GetSize() > 1) && page->GetSize() >= page->GetMinSize()) {
-      LOG_DEBUG("no need to merge");
-      return;
-    }
     auto parent_guard = std::move(ctx.write_set_.back());
     ctx.write_set_.pop_back();
     auto parent_page = parent_guard.template AsMut<InternalPage>();
@@ -681,6 +730,9 @@ void BPLUSTREE_TYPE::DoMerge(Context &ctx) {
         // try borrow node from left child
         // must be careful , acquiring leaf sibling lock might cause deadlock
         // Regaining lock from left to right
+        // (This drop-and-refetch is the one re-latch in the sweep and it cannot be fused away:
+        // scans latch-couple leaves left-to-right, so grabbing the left sibling while still
+        // holding this page would deadlock against a reader sitting on the left leaf.)
         page_guard.Drop();
         auto left_child_page_guard = bpm_->FetchPageWrite(parent_page->ValueAt(index - 1));
         page_guard = std::move(bpm_->FetchPageWrite(parent_page->ValueAt(index)));
@@ -698,12 +750,8 @@ void BPLUSTREE_TYPE::DoMerge(Context &ctx) {
           // set new max left child's key at parent
           parent_page->SetKeyAt(index, left_child_page->KeyAt(left_size - move_num - 1));
           self_page->SetSize(size + move_num);
-          for (int i = size - 1; i >= 0; i--) {  // update right child node
-            self_page->SetMappingAt(i + move_num, self_page->MappingAt(i));
-          }
-          for (int i = 0; i < move_num; i++) {  // copy to
-            self_page->SetMappingAt(i, left_child_page->MappingAt(i + left_size - move_num));
-          }
+          self_page->CopyMappings(move_num, self_page, 0, size);
+          self_page->CopyMappings(0, left_child_page, left_size - move_num, move_num);
           left_child_page->SetSize(left_size - move_num);
           return;
         }
@@ -711,24 +759,22 @@ void BPLUSTREE_TYPE::DoMerge(Context &ctx) {
         // if parent is root, just copy to root and avoiding fetching header page's latch
         if (parent_size < 3 && ctx.IsRootPage(parent_guard.PageId())) {
           auto root_page = parent_guard.template AsMut<LeafPage>();
-          for (int i = 0; i < left_size; i++) {
-            root_page->SetMappingAt(i, left_child_page->MappingAt(i));
-          }
-          for (int i = 0; i < size; i++) {
-            root_page->SetMappingAt(i + left_size, self_page->MappingAt(i));
-          }
+          root_page->CopyMappings(0, left_child_page, 0, left_size);
+          root_page->CopyMappings(left_size, self_page, 0, size);
           root_page->SetPageType(IndexPageType::LEAF_PAGE);
           root_page->SetSize(left_size + size);
           root_page->SetMaxSize(left_child_page->GetMaxSize());
           root_page->SetNextPageId(INVALID_PAGE_ID);
+          // Both children are orphaned while still looking like rightmost leaves; kill the
+          // append hint before their latches go, so a latched hint re-read cannot trust them.
+          rightmost_leaf_.store(INVALID_PAGE_ID, std::memory_order_release);
           return;
         }
-        for (int i = 0; i < size; i++) {
-          left_child_page->SetMappingAt(i + left_size, self_page->MappingAt(i));
-        }
+        left_child_page->CopyMappings(left_size, self_page, 0, size);
         left_child_page->SetNextPageId(self_page->GetNextPageId());
         left_child_page->SetSize(left_size + size);
         parent_page->RemoveAt(index);
+        rightmost_leaf_.store(INVALID_PAGE_ID, std::memory_order_release);  // self_page is orphaned
         if (parent_page->GetSize() > 1) {  // No need to propogate to root!
           return;
         }
@@ -747,12 +793,8 @@ void BPLUSTREE_TYPE::DoMerge(Context &ctx) {
           // set new max left child's key at parent
           parent_page->SetKeyAt(index + 1, right_child_page->KeyAt(move_num - 1));
           self_page->SetSize(size + move_num);
-          for (int i = 0; i < move_num; i++) {
-            self_page->SetMappingAt(i + size, right_child_page->MappingAt(i));
-          }
-          for (int i = 0; i < right_size - move_num; i++) {
-            right_child_page->SetMappingAt(i, right_child_page->MappingAt(i + move_num));
-          }
+          self_page->CopyMappings(size, right_child_page, 0, move_num);
+          right_child_page->CopyMappings(0, right_child_page, move_num, right_size - move_num);
           right_child_page->SetSize(right_size - move_num);
           return;
         }
@@ -760,24 +802,20 @@ void BPLUSTREE_TYPE::DoMerge(Context &ctx) {
         // if parent is root, just copy to root and avoiding fetching header page's latch
         if (parent_size < 3 && ctx.IsRootPage(parent_guard.PageId())) {
           auto root_page = parent_guard.template AsMut<LeafPage>();
-          for (int i = 0; i < size; i++) {
-            root_page->SetMappingAt(i, self_page->MappingAt(i));
-          }
-          for (int i = 0; i < right_size; i++) {
-            root_page->SetMappingAt(i + size, right_child_page->MappingAt(i));
-          }
+          root_page->CopyMappings(0, self_page, 0, size);
+          root_page->CopyMappings(size, right_child_page, 0, right_size);
           root_page->SetPageType(IndexPageType::LEAF_PAGE);
           root_page->SetSize(right_size + size);
           root_page->SetMaxSize(self_page->GetMaxSize());
           root_page->SetNextPageId(INVALID_PAGE_ID);
+          rightmost_leaf_.store(INVALID_PAGE_ID, std::memory_order_release);  // both children orphaned
           return;
         }
-        for (int i = 0; i < right_size; i++) {
-          self_page->SetMappingAt(i + size, right_child_page->MappingAt(i));
-        }
+        self_page->CopyMappings(size, right_child_page, 0, right_size);
         self_page->SetNextPageId(right_child_page->GetNextPageId());
         self_page->SetSize(size + right_size);
         parent_page->RemoveAt(index + 1);
+        rightmost_leaf_.store(INVALID_PAGE_ID, std::memory_order_release);  // right child is orphaned
         if (parent_page->GetSize() > 1) {  // No need to propogate to root!
           // LOG_DEBUG("No Need To Propagate to Root size : %d", parent_page->GetSize());
           return;
@@ -802,28 +840,17 @@ void BPLUSTREE_TYPE::DoMerge(Context &ctx) {
           auto parent_key = parent_page->KeyAt(index);
           parent_page->SetKeyAt(index, left_child_page->KeyAt(left_size - move_num));
           self_page->SetSize(size + move_num);
-          for (int i = size - 1; i >= 0; i--) {
-            self_page->SetMappingAt(i + move_num, self_page->MappingAt(i));
-          }
-
+          self_page->CopyMappings(move_num, self_page, 0, size);
           self_page->SetKeyAt(move_num, parent_key);
-          for (int i = 0; i < move_num; i++) {  // copy to
-            self_page->SetMappingAt(i, left_child_page->MappingAt(i + left_size - move_num));
-          }
-          self_page->SetKeyAt(0, KeyType{});
+          self_page->CopyMappings(0, left_child_page, left_size - move_num, move_num);
           left_child_page->SetSize(left_size - move_num);
           return;
         }
         // if parent is root, just copy to root and avoiding fetching header page's latch
         if (parent_size < 3 && ctx.IsRootPage(parent_guard.PageId())) {
           auto parent_key = parent_page->KeyAt(1);
-          for (int i = 0; i < left_size; i++) {
-            parent_page->SetMappingAt(i, left_child_page->MappingAt(i));
-          }
-          for (int i = 0; i < size; i++) {
-            parent_page->SetMappingAt(i + left_size, self_page->MappingAt(i));
-          }
-          parent_page->SetKeyAt(0, KeyType{});
+          parent_page->CopyMappings(0, left_child_page, 0, left_size);
+          parent_page->CopyMappings(left_size, self_page, 0, size);
           parent_page->SetKeyAt(left_size, parent_key);
           parent_page->SetPageType(IndexPageType::INTERNAL_PAGE);
           parent_page->SetSize(left_size + size);
@@ -832,9 +859,7 @@ void BPLUSTREE_TYPE::DoMerge(Context &ctx) {
         // we cannot borrow node from sibling, then merge with left and make parent empty and propagate to root
         // merge with left child
         left_child_page->SetMappingAt(left_size, {parent_page->KeyAt(index), self_page->ValueAt(0)});
-        for (int i = 1; i < size; i++) {  // copy remaining node to left child
-          left_child_page->SetMappingAt(i + left_size, self_page->MappingAt(i));
-        }
+        left_child_page->CopyMappings(left_size + 1, self_page, 1, size - 1);
         // parent_page->SetMappingAt(index - 1, {parent_page->KeyAt(index - 1), left_child_page->ValueAt(0)});
         left_child_page->SetSize(left_size + size);
         parent_page->RemoveAt(index);
@@ -857,26 +882,16 @@ void BPLUSTREE_TYPE::DoMerge(Context &ctx) {
           self_page->SetMappingAt(size, {parent_page->KeyAt(index + 1), right_child_page->ValueAt(0)});
           parent_page->SetKeyAt(index + 1, right_child_page->KeyAt(move_num));
           self_page->SetSize(size + move_num);
-          for (int i = 1; i < move_num; i++) {
-            self_page->SetMappingAt(i + size, right_child_page->MappingAt(i));
-          }
-          for (int i = 0; i < right_size - move_num; i++) {
-            right_child_page->SetMappingAt(i, right_child_page->MappingAt(i + move_num));
-          }
-          right_child_page->SetKeyAt(0, KeyType{});
+          self_page->CopyMappings(size + 1, right_child_page, 1, move_num - 1);
+          right_child_page->CopyMappings(0, right_child_page, move_num, right_size - move_num);
           right_child_page->SetSize(right_size - move_num);
           return;
         }
         // if parent is root, just copy to root and avoiding fetching header page's latch
         if (parent_size < 3 && ctx.IsRootPage(parent_guard.PageId())) {
           auto parent_key = parent_page->KeyAt(1);
-          for (int i = 0; i < size; i++) {
-            parent_page->SetMappingAt(i, self_page->MappingAt(i));
-          }
-          for (int i = 0; i < right_size; i++) {
-            parent_page->SetMappingAt(i + size, right_child_page->MappingAt(i));
-          }
-          parent_page->SetKeyAt(0, KeyType{});
+          parent_page->CopyMappings(0, self_page, 0, size);
+          parent_page->CopyMappings(size, right_child_page, 0, right_size);
           parent_page->SetKeyAt(size, parent_key);
           parent_page->SetPageType(IndexPageType::INTERNAL_PAGE);
           parent_page->SetSize(right_size + size);
@@ -884,9 +899,7 @@ void BPLUSTREE_TYPE::DoMerge(Context &ctx) {
         }
         // merge to left_child and propagate to root!
         self_page->SetMappingAt(size, {parent_page->KeyAt(index + 1), right_child_page->ValueAt(0)});
-        for (int i = 1; i < right_size; i++) {
-          self_page->SetMappingAt(i + size, right_child_page->MappingAt(i));
-        }
+        self_page->CopyMappings(size + 1, right_child_page, 1, right_size - 1);
         self_page->SetSize(size + right_size);
         parent_page->RemoveAt(index + 1);
         if (parent_page->GetSize() > 1) {  // No need to propogate to root!
@@ -909,11 +922,17 @@ void BPLUSTREE_TYPE::DoMerge(Context &ctx) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertFromFile(const std::string &file_name, Transaction *txn) {
-  int64_t key;
+  // Parse the whole file up front, then insert in sorted order: one tight istream pass instead
+  // of N interleaved reads, and sorted keys make successive inserts land in the same (hot) leaf
+  // so the descents stay cache-resident. Also stops the old loop from re-inserting the last key
+  // on EOF (harmless only because Insert rejects duplicates).
   std::ifstream input(file_name);
-  while (input) {
-    input >> key;
-
+  std::vector<int64_t> keys;
+  for (int64_t key; input >> key;) {
+    keys.push_back(key);
+  }
+  std::sort(keys.begin(), keys.end());
+  for (auto key : keys) {
     KeyType index_key;
     index_key.SetFromInteger(key);
     RID rid(key);
@@ -926,10 +945,15 @@ void BPLUSTREE_TYPE::InsertFromFile(const std::string &file_name, Transaction *t
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::RemoveFromFile(const std::string &file_name, Transaction *txn) {
-  int64_t key;
+  // Same batched shape as InsertFromFile: parse everything, sort, then remove with high leaf
+  // locality. Removal order does not affect the surviving key set.
   std::ifstream input(file_name);
-  while (input) {
-    input >> key;
+  std::vector<int64_t> keys;
+  for (int64_t key; input >> key;) {
+    keys.push_back(key);
+  }
+  std::sort(keys.begin(), keys.end());
+  for (auto key : keys) {
     KeyType index_key;
     index_key.SetFromInteger(key);
     Remove(index_key, txn);
@@ -949,11 +973,14 @@ void BPLUSTREE_TYPE::PrintTree(page_id_t page_id, const BPlusTreePage *page) {
     auto *leaf = reinterpret_cast<const LeafPage *>(page);
     std::cout << "Leaf Page: " << page_id << "\tNext: " << leaf->GetNextPageId() << std::endl;
 
-    // Print the contents of the leaf page.
+    // Print the contents of the leaf page. The size goes into a local: nothing in the loop body
+    // can change it, but the compiler cannot prove that past the stream calls and would reload
+    // it every iteration.
     std::cout << "Contents: ";
-    for (int i = 0; i < leaf->GetSize(); i++) {
+    const int size = leaf->GetSize();
+    for (int i = 0; i < size; i++) {
       std::cout << leaf->KeyAt(i);
-      if ((i + 1) < leaf->GetSize()) {
+      if ((i + 1) < size) {
         std::cout << ", ";
       }
     }
@@ -966,15 +993,16 @@ void BPLUSTREE_TYPE::PrintTree(page_id_t page_id, const BPlusTreePage *page) {
 
     // Print the contents of the internal page.
     std::cout << "Contents: ";
-    for (int i = 0; i < internal->GetSize(); i++) {
+    const int size = internal->GetSize();
+    for (int i = 0; i < size; i++) {
       std::cout << internal->KeyAt(i) << ": " << internal->ValueAt(i);
-      if ((i + 1) < internal->GetSize()) {
+      if ((i + 1) < size) {
         std::cout << ", ";
       }
     }
     std::cout << std::endl;
     std::cout << std::endl;
-    for (int i = 0; i < internal->GetSize(); i++) {
+    for (int i = 0; i < size; i++) {
       auto guard = bpm_->FetchPageBasic(internal->ValueAt(i));
       PrintTree(guard.PageId(), guard.template As<BPlusTreePage>());
     }
@@ -991,12 +1019,17 @@ void BPLUSTREE_TYPE::Draw(BufferPoolManager *bpm, const std::string &outf) {
     return;
   }
 
-  std::ofstream out(outf);
-  out << "digraph G {" << std::endl;
+  // Render the whole graph into one in-memory buffer and write it out in a single call: every
+  // ofstream operator<< pays for a sentry, locale formatting and a locked write, which dominates
+  // the runtime on large trees.
+  fmt::memory_buffer buf;
+  fmt::format_to(std::back_inserter(buf), "digraph G {{\n");
   auto root_page_id = GetRootPageId();
   auto guard = bpm->FetchPageBasic(root_page_id);
-  ToGraph(guard.PageId(), guard.template As<BPlusTreePage>(), out);
-  out << "}" << std::endl;
+  ToGraph(guard.PageId(), guard.template As<BPlusTreePage>(), buf);
+  fmt::format_to(std::back_inserter(buf), "}}\n");
+  std::ofstream out(outf);
+  out.write(buf.data(), buf.size());
   out.close();
 }
 
@@ -1004,78 +1037,74 @@ void BPLUSTREE_TYPE::Draw(BufferPoolManager *bpm, const std::string &outf) {
  * This method is used for debug only, You don't need to modify
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::ToGraph(page_id_t page_id, const BPlusTreePage *page, std::ofstream &out) {
+void BPLUSTREE_TYPE::ToGraph(page_id_t page_id, const BPlusTreePage *page, fmt::memory_buffer &buf) {
+  auto out = std::back_inserter(buf);
   std::string leaf_prefix("LEAF_");
   std::string internal_prefix("INT_");
   if (page->IsLeafPage()) {
     auto *leaf = reinterpret_cast<const LeafPage *>(page);
-    // Print node name
-    out << leaf_prefix << page_id;
-    // Print node properties
-    out << "[shape=plain color=green ";
+    // Print node name and properties
+    fmt::format_to(out, "{}{}[shape=plain color=green ", leaf_prefix, page_id);
     // Print data of the node
-    out << "label=<<TABLE BORDER=\"0\" CELLBORDER=\"1\" CELLSPACING=\"0\" CELLPADDING=\"4\">\n";
+    fmt::format_to(out, "label=<<TABLE BORDER=\"0\" CELLBORDER=\"1\" CELLSPACING=\"0\" CELLPADDING=\"4\">\n");
     // Print data
-    out << "<TR><TD COLSPAN=\"" << leaf->GetSize() << "\">P=" << page_id << "</TD></TR>\n";
-    out << "<TR><TD COLSPAN=\"" << leaf->GetSize() << "\">"
-        << "max_size=" << leaf->GetMaxSize() << ",min_size=" << leaf->GetMinSize() << ",size=" << leaf->GetSize()
-        << "</TD></TR>\n";
-    out << "<TR>";
-    for (int i = 0; i < leaf->GetSize(); i++) {
-      out << "<TD>" << leaf->KeyAt(i) << "</TD>\n";
+    const int size = leaf->GetSize();
+    fmt::format_to(out, "<TR><TD COLSPAN=\"{}\">P={}</TD></TR>\n", size, page_id);
+    fmt::format_to(out, "<TR><TD COLSPAN=\"{}\">max_size={},min_size={},size={}</TD></TR>\n", size,
+                   leaf->GetMaxSize(), leaf->GetMinSize(), size);
+    fmt::format_to(out, "<TR>");
+    for (int i = 0; i < size; i++) {
+      fmt::format_to(out, "<TD>{}</TD>\n", leaf->KeyAt(i).ToString());
     }
-    out << "</TR>";
+    fmt::format_to(out, "</TR>");
     // Print table end
-    out << "</TABLE>>];\n";
+    fmt::format_to(out, "</TABLE>>];\n");
     // Print Leaf node link if there is a next page
     if (leaf->GetNextPageId() != INVALID_PAGE_ID) {
-      out << leaf_prefix << page_id << " -> " << leaf_prefix << leaf->GetNextPageId() << ";\n";
-      out << "{rank=same " << leaf_prefix << page_id << " " << leaf_prefix << leaf->GetNextPageId() << "};\n";
+      fmt::format_to(out, "{}{} -> {}{};\n", leaf_prefix, page_id, leaf_prefix, leaf->GetNextPageId());
+      fmt::format_to(out, "{{rank=same {}{} {}{}}};\n", leaf_prefix, page_id, leaf_prefix, leaf->GetNextPageId());
     }
   } else {
     auto *inner = reinterpret_cast<const InternalPage *>(page);
-    // Print node name
-    out << internal_prefix << page_id;
-    // Print node properties
-    out << "[shape=plain color=pink ";  // why not?
+    // Print node name and properties
+    fmt::format_to(out, "{}{}[shape=plain color=pink ", internal_prefix, page_id);  // why not?
     // Print data of the node
-    out << "label=<<TABLE BORDER=\"0\" CELLBORDER=\"1\" CELLSPACING=\"0\" CELLPADDING=\"4\">\n";
+    fmt::format_to(out, "label=<<TABLE BORDER=\"0\" CELLBORDER=\"1\" CELLSPACING=\"0\" CELLPADDING=\"4\">\n");
     // Print data
-    out << "<TR><TD COLSPAN=\"" << inner->GetSize() << "\">P=" << page_id << "</TD></TR>\n";
-    out << "<TR><TD COLSPAN=\"" << inner->GetSize() << "\">"
-        << "max_size=" << inner->GetMaxSize() << ",min_size=" << inner->GetMinSize() << ",size=" << inner->GetSize()
-        << "</TD></TR>\n";
-    out << "<TR>";
-    for (int i = 0; i < inner->GetSize(); i++) {
-      out << "<TD PORT=\"p" << inner->ValueAt(i) << "\">";
+    const int size = inner->GetSize();
+    fmt::format_to(out, "<TR><TD COLSPAN=\"{}\">P={}</TD></TR>\n", size, page_id);
+    fmt::format_to(out, "<TR><TD COLSPAN=\"{}\">max_size={},min_size={},size={}</TD></TR>\n", size,
+                   inner->GetMaxSize(), inner->GetMinSize(), size);
+    fmt::format_to(out, "<TR>");
+    for (int i = 0; i < size; i++) {
       if (i > 0) {
-        out << inner->KeyAt(i);
+        fmt::format_to(out, "<TD PORT=\"p{}\">{}</TD>\n", inner->ValueAt(i), inner->KeyAt(i).ToString());
       } else {
-        out << " ";
+        fmt::format_to(out, "<TD PORT=\"p{}\"> </TD>\n", inner->ValueAt(i));
       }
-      out << "</TD>\n";
     }
-    out << "</TR>";
+    fmt::format_to(out, "</TR>");
     // Print table end
-    out << "</TABLE>>];\n";
-    // Print leaves
-    for (int i = 0; i < inner->GetSize(); i++) {
+    fmt::format_to(out, "</TABLE>>];\n");
+    // Print leaves. The sibling test only needs the previous child's leafness, and its page id
+    // is inner->ValueAt(i - 1), so remembering one bool replaces a second FetchPageBasic (and
+    // its unpin) per child pair.
+    bool prev_is_leaf = false;
+    for (int i = 0; i < size; i++) {
       auto child_guard = bpm_->FetchPageBasic(inner->ValueAt(i));
       auto child_page = child_guard.template As<BPlusTreePage>();
-      ToGraph(child_guard.PageId(), child_page, out);
-      if (i > 0) {
-        auto sibling_guard = bpm_->FetchPageBasic(inner->ValueAt(i - 1));
-        auto sibling_page = sibling_guard.template As<BPlusTreePage>();
-        if (!sibling_page->IsLeafPage() && !child_page->IsLeafPage()) {
-          out << "{rank=same " << internal_prefix << sibling_guard.PageId() << " " << internal_prefix
-              << child_guard.PageId() << "};\n";
-        }
+      ToGraph(child_guard.PageId(), child_page, buf);
+      if (i > 0 && !prev_is_leaf && !child_page->IsLeafPage()) {
+        fmt::format_to(out, "{{rank=same {}{} {}{}}};\n", internal_prefix, inner->ValueAt(i - 1), internal_prefix,
+                       child_guard.PageId());
       }
-      out << internal_prefix << page_id << ":p" << child_guard.PageId() << " -> ";
+      prev_is_leaf = child_page->IsLeafPage();
       if (child_page->IsLeafPage()) {
-        out << leaf_prefix << child_guard.PageId() << ";\n";
+        fmt::format_to(out, "{}{}:p{} -> {}{};\n", internal_prefix, page_id, child_guard.PageId(), leaf_prefix,
+                       child_guard.PageId());
       } else {
-        out << internal_prefix << child_guard.PageId() << ";\n";
+        fmt::format_to(out, "{}{}:p{} -> {}{};\n", internal_prefix, page_id, child_guard.PageId(), internal_prefix,
+                       child_guard.PageId());
       }
     }
   }
@@ -1113,11 +1142,16 @@ auto BPLUSTREE_TYPE::ToPrintableBPlusTree(page_id_t root_id) -> PrintableBPlusTr
   auto internal_page = root_page_guard.template As<InternalPage>();
   proot.keys_ = internal_page->ToString();
   proot.size_ = 0;
-  for (int i = 0; i < internal_page->GetSize(); i++) {
+  // One allocation for the child vector, and moved-in children: each PrintableBPlusTree owns a
+  // keys string and a child vector of its own, so copying them used to duplicate the whole
+  // subtree's heap blocks on every push_back regrow.
+  const int size = internal_page->GetSize();
+  proot.children_.reserve(size);
+  for (int i = 0; i < size; i++) {
     page_id_t child_id = internal_page->ValueAt(i);
     PrintableBPlusTree child_node = ToPrintableBPlusTree(child_id);
     proot.size_ += child_node.size_;
-    proot.children_.push_back(child_node);
+    proot.children_.push_back(std::move(child_node));
   }
 
   return proot;
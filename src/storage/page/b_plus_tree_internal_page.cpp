@@ -37,19 +37,19 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
   // replace with your own code
-  KeyType key = array_[index].first;
+  KeyType key = keys_[index];
   return key;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { keys_[index] = key; }
 
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return values_[index]; }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
@@ -69,10 +69,12 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAt(int index, const MappingType &pair
     return;
   }
   int size = GetSize();
-  for (int i = size; size > 0 && i > index; i--) {
-    array_[i] = array_[i - 1];
+  if (size > index) {
+    std::copy_backward(&keys_[index], &keys_[size], &keys_[size + 1]);
+    std::copy_backward(&values_[index], &values_[size], &values_[size + 1]);
   }
-  array_[index] = pair;
+  keys_[index] = pair.first;
+  values_[index] = pair.second;
   IncreaseSize(1);
 }
 
@@ -83,9 +85,8 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAt(int index) {
     return;
   }
   int size = GetSize();
-  for (int i = index; i < size - 1; i++) {
-    array_[i] = array_[i + 1];
-  }
+  std::copy(&keys_[index + 1], &keys_[size], &keys_[index]);
+  std::copy(&values_[index + 1], &values_[size], &values_[index]);
   IncreaseSize(-1);
 }
 
@@ -51,14 +51,14 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_pa
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
   // replace with your own code
-  KeyType key = array_[index].first;
+  KeyType key = keys_[index];
   return key;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType {
   // replace with your own code
-  auto value = array_[index].second;
+  auto value = values_[index];
   return value;
 }
 
@@ -74,10 +74,12 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertAt(int index, const MappingType &pair) {
     LOG_WARN("szie(%d) exceeds max_leaf_page_size(%d)!", size, max_leaf_page_size);
     // size = max_leaf_page_size - 1;
   }
-  for (int i = size; size > 0 && i > index; i--) {
-    array_[i] = array_[i - 1];
+  if (size > index) {
+    std::copy_backward(&keys_[index], &keys_[size], &keys_[size + 1]);
+    std::copy_backward(&values_[index], &values_[size], &values_[size + 1]);
   }
-  array_[index] = pair;
+  keys_[index] = pair.first;
+  values_[index] = pair.second;
   IncreaseSize(1);
 }
 
@@ -88,9 +90,8 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAt(int index) {
     return;
   }
   int size = GetSize();
-  for (int i = index; i < size; i++) {
-    array_[i] = array_[i + 1];
-  }
+  std::copy(&keys_[index + 1], &keys_[size], &keys_[index]);
+  std::copy(&values_[index + 1], &values_[size], &values_[index]);
   IncreaseSize(-1);
 }
 
@@ -10,12 +10,12 @@ BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept {
 }
 
 void BasicPageGuard::Drop() {
-  if (bpm_ != nullptr && page_ != nullptr) {
-    bpm_->UnpinPage(PageId(), is_dirty_);
+  auto page = PagePtr();
+  if (bpm_ != nullptr && page != nullptr) {
+    bpm_->UnpinFrame(page, IsDirty());
   }
   bpm_ = nullptr;
-  page_ = nullptr;
-  is_dirty_ = false;
+  tagged_page_ = 0;
 }
 
 auto BasicPageGuard::operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard & {
@@ -44,13 +44,13 @@ auto ReadPageGuard::operator=(ReadPageGuard &&that) noexcept -> ReadPageGuard &
 }
 
 void ReadPageGuard::Drop() {
-  if (guard_.bpm_ != nullptr && guard_.page_ != nullptr) {
-    guard_.bpm_->UnpinPage(guard_.PageId(), guard_.is_dirty_);
-    guard_.page_->RUnlatch();
+  auto page = guard_.PagePtr();
+  if (guard_.bpm_ != nullptr && page != nullptr) {
+    guard_.bpm_->UnpinFrame(page, guard_.IsDirty());
+    page->RUnlatch();
   }
   guard_.bpm_ = nullptr;
-  guard_.page_ = nullptr;
-  guard_.is_dirty_ = false;
+  guard_.tagged_page_ = 0;
 }
 
 ReadPageGuard::~ReadPageGuard() { Drop(); }  // NOLINT
@@ -70,13 +70,13 @@ auto WritePageGuard::operator=(WritePageGuard &&that) noexcept -> WritePageGuard
 }
 
 void WritePageGuard::Drop() {
-  if (guard_.bpm_ != nullptr && guard_.page_ != nullptr) {
-    guard_.bpm_->UnpinPage(guard_.PageId(), guard_.is_dirty_);
-    guard_.page_->WUnlatch();
+  auto page = guard_.PagePtr();
+  if (guard_.bpm_ != nullptr && page != nullptr) {
+    guard_.bpm_->UnpinFrame(page, guard_.IsDirty());
+    page->WUnlatch();
   }
   guard_.bpm_ = nullptr;
-  guard_.page_ = nullptr;
-  guard_.is_dirty_ = false;
+  guard_.tagged_page_ = 0;
 }
 
 WritePageGuard::~WritePageGuard() { Drop(); }  // NOLINT
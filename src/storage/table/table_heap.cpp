@@ -71,6 +71,7 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
 
   auto page = page_guard.AsMut<TablePage>();
   auto slot_id = *page->InsertTuple(meta, tuple);
+  insert_count_.fetch_add(1, std::memory_order_relaxed);
 
   // only allow one insertion at a time, otherwise it will deadlock.
   guard.unlock();
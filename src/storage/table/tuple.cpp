@@ -21,8 +21,11 @@
 namespace bustub {
 
 // TODO(Amadou): It does not look like nulls are supported. Add a null bitmap?
-Tuple::Tuple(std::vector<Value> values, const Schema *schema) {
+Tuple::Tuple(std::vector<Value> values, const Schema *schema) { AssembleFrom(values, schema); }
+
+void Tuple::AssembleFrom(const std::vector<Value> &values, const Schema *schema) {
   assert(values.size() == schema->GetColumnCount());
+  rid_ = RID{};
 
   // 1. Calculate the size of the tuple.
   uint32_t tuple_size = schema->GetLength();